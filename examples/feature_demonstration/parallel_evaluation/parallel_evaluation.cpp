@@ -0,0 +1,63 @@
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "../../../atf.hpp"
+
+// sums `data` in blocks of `BLOCK_SIZE` elements, each of which is summed `UNROLL` elements at a time
+atf::cost_t blocked_sum( const std::vector<float> &data, size_t BLOCK_SIZE, size_t UNROLL )
+{
+  auto start = std::chrono::steady_clock::now();
+
+  volatile float result = 0.0f;
+  for (size_t block_offset = 0; block_offset < data.size(); block_offset += BLOCK_SIZE)
+  {
+    float block_sum = 0.0f;
+    for (size_t i = block_offset; i < block_offset + BLOCK_SIZE; i += UNROLL)
+      for (size_t j = i; j < i + UNROLL; ++j)
+        block_sum += data[ j ];
+    result = result + block_sum;
+  }
+
+  return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start ).count();
+}
+
+int main( int argc, char* argv[] )
+{
+  // number of threads on which the configurations are evaluated (default: all hardware threads)
+  size_t num_threads = ( argc > 1 ) ? std::strtoul( argv[1], nullptr, 10 ) : std::thread::hardware_concurrency();
+
+  // input size
+  size_t N = 1 << 22;
+
+  // Step 1: Generate the Search Space
+  auto BLOCK_SIZE = atf::tuning_parameter( "BLOCK_SIZE"                 ,
+                                           atf::interval<size_t>( 1,N ) ,
+                                           atf::divides( N )            );
+
+  auto UNROLL     = atf::tuning_parameter( "UNROLL"                     ,
+                                           atf::interval<size_t>( 1,64 ),
+                                           atf::divides( BLOCK_SIZE )   );
+
+  // Step 2: Implement a Cost Function; it is called concurrently, so it must not modify shared state
+  std::vector<float> data( N ); for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<float>((i % 10) + 1);
+
+  auto cf_blocked_sum = [&data]( atf::configuration &config ) -> atf::cost_t {
+    return blocked_sum( data, config["BLOCK_SIZE"].value(), config["UNROLL"].value() );
+  };
+
+  // Step 3: Explore the Search Space; random search requests a batch of `num_threads` configurations at a time, which are
+  //         evaluated concurrently (note: concurrently evaluated configurations share the cores and memory bandwidth, which
+  //         distorts runtime measurements -- parallel evaluation pays off for cost functions that mostly wait, e.g., for a
+  //         remote machine or an accelerator)
+  auto tuning_start  = std::chrono::steady_clock::now();
+  auto tuning_result = atf::tuner().tuning_parameters( BLOCK_SIZE, UNROLL )
+                                   .search_technique( atf::random_search() )
+                                   .evaluation_threads( num_threads )
+                                   .tune( cf_blocked_sum, atf::evaluations(64) );
+
+  std::cout << "tuning on " << num_threads << " thread(s) took "
+            << std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - tuning_start ).count() << "ms, "
+            << "best cost: " << tuning_result.min_cost() << "ns" << std::endl;
+}
@@ -23,6 +23,8 @@
 #include "atf/round_robin.hpp"
 
 #include "atf/exploration_engine.hpp"
+#include "atf/tuning_log.hpp"
+#include "atf/trace.hpp"
 
 #ifdef ENABLE_OPENCL_COST_FUNCTION
 #include "atf/ocl_wrapper.hpp"
@@ -30,6 +32,9 @@
 #ifdef ENABLE_CUDA_COST_FUNCTION
 #include "atf/cuda_wrapper.hpp"
 #endif
+#include "atf/isolation.hpp"
+#include "atf/racing.hpp"
+#include "atf/measurement.hpp"
 #include "atf/cpp_cf.hpp"
 #include "atf/bash_cf.hpp"
 
@@ -56,7 +61,7 @@ using cost = cond::result;
 class tuner {
   public:
     tuner() = default;
-    tuner(const tuner& other) : _engine(other._engine), _is_stepping(false), _stepping_config(), _stepping_start(), _stepping_log(), _log_file(other._log_file) {}
+    tuner(const tuner& other) : _engine(other._engine), _log_file(other._log_file), _log_format(other._log_format), _trace_file(other._trace_file), _is_stepping(false), _stepping_config(), _stepping_start(), _stepping_log(), _stepping_columnar_log() {}
     ~tuner() {
       if (_is_stepping) {
         _engine.finalize();
@@ -68,9 +73,20 @@ class tuner {
           std::cout << "tuning finished" << std::endl;
         }
         _stepping_log.close();
+        _stepping_columnar_log.close();
+        if (!_trace_file.empty()) {
+          stop_tracing();
+          write_chrome_trace(_trace_file);
+        }
       }
     }
 
+    // must be set before the tuning parameters
+    tuner& search_space_file(const std::string &search_space_file, const std::string &key = "") {
+      _engine.set_search_space_file(search_space_file, key);
+      return *this;
+    }
+
     template< typename... Ts, typename... range_ts, typename... callables >
     tuner& tuning_parameters(tp_t<Ts,range_ts,callables>&... tps) {
       _engine(tps...);
@@ -83,6 +99,17 @@ class tuner {
       return *this;
     }
 
+    // counts the configurations without generating the search space
+    template< typename... Ts, typename... range_ts, typename... callables >
+    search_space_size count_configs(tp_t<Ts,range_ts,callables>&... tps) {
+      return _engine.count_configs(tps...);
+    }
+
+    template< typename... Ts, typename... G_CLASSES >
+    search_space_size count_configs(G_class<Ts...> G_class, G_CLASSES... G_classes) {
+      return _engine.count_configs(G_class, G_classes...);
+    }
+
     template< typename search_technique_t, typename std::enable_if<std::is_base_of<search_technique, search_technique_t>::value, bool>::type = true >
     tuner& search_technique(const search_technique_t& search_technique) {
       _engine.set_search_technique(search_technique);
@@ -100,9 +127,81 @@ class tuner {
       return *this;
     }
 
-    tuner& log_file(const std::string &log_file) {
-      _engine.set_log_file(log_file);
+    // "false": the TPs passed to "tuning_parameters" are not split into independent groups, but form one group in their order;
+    // must be called before "tuning_parameters"
+    tuner& split_independent_tps(bool split) {
+      _engine.set_split_independent_tps(split);
+      return *this;
+    }
+
+    // evaluates the configurations requested by the search technique in one call on "num_threads" threads concurrently
+    tuner& evaluation_threads(size_t num_threads) {
+      _engine.set_num_evaluation_threads(num_threads);
+      return *this;
+    }
+
+    // overlaps the decoding, compilation (for cost functions with "compile" and "measure" stages), and measurement of the
+    // configurations requested by the search technique in one call; the queues between the stages hold "queue_capacity" configurations,
+    // and the search technique is asked for as many configurations per call as the pipeline holds
+    tuner& pipelined(bool pipelined, size_t queue_capacity = 2) {
+      _engine.set_pipelined(pipelined, queue_capacity);
+      return *this;
+    }
+
+    // caches the costs of evaluated configurations by their index in the search space, such that configurations requested again
+    // (e.g., different coordinates selecting the same configuration) are not evaluated again; "capacity" 0: unbounded, otherwise
+    // the least recently used costs are evicted
+    tuner& cache_results(bool enabled, size_t capacity = 0) {
+      _engine.set_result_cache(enabled, capacity);
+      return *this;
+    }
+
+    // appends every evaluation to a tuning database at "path", which "resume" continues from after a crash
+    tuner& database(const std::string &path) {
+      _engine.set_database(path, false);
+      return *this;
+    }
+
+    // restores the evaluations recorded in the tuning database at "db_path" (if it exists) into the tuning status, and continues
+    // the run: configurations evaluated before are not evaluated again, and new evaluations are appended to the database
+    tuner& resume(const std::string &db_path) {
+      _engine.set_database(db_path, true);
+      return *this;
+    }
+
+    // saves the search technique's state to "path" every "interval" evaluations; "resume" continues the technique from it
+    tuner& checkpoint(const std::string &path, size_t interval = 100) {
+      _engine.set_checkpoint(path, interval);
+      return *this;
+    }
+
+    // rows of the log file are buffered and written by a background thread every "flush_interval_ms" milliseconds (or once half of
+    // the buffer of "capacity" bytes is filled), such that tuning does not wait for the disk
+    tuner& log_buffer(size_t capacity, size_t flush_interval_ms = 100) {
+      _engine.set_log_buffer(capacity, std::chrono::milliseconds(flush_interval_ms));
+      return *this;
+    }
+
+    // the cost function returns a vector of costs, one per objective "names" (e.g., runtime, energy); the Pareto front of the
+    // vectors is tracked in the tuning status, and the search technique minimizes their "scalarization"
+    tuner& objectives(const std::vector<std::string> &names, const atf::scalarization &scalarization = atf::objective(0)) {
+      _engine.set_objectives(names, scalarization);
+      return *this;
+    }
+
+    // "log_format::binary": compact columnar log (see "atf::tuning_log" and "atf::convert_to_csv"), for long tuning runs
+    tuner& log_file(const std::string &log_file, atf::log_format format = atf::log_format::csv) {
+      _engine.set_log_file(log_file, format);
       _log_file = log_file;
+      _log_format = format;
+      return *this;
+    }
+
+    // records where the time of tuning goes (search technique, compilation, buffer fills, kernel runs, result checks, logging) with
+    // nanosecond spans per thread, and writes them to "trace_file" as Chrome trace JSON (to be opened in Perfetto)
+    tuner& trace_file(const std::string &trace_file) {
+      _engine.set_trace_file(trace_file);
+      _trace_file = trace_file;
       return *this;
     }
 
@@ -125,16 +224,35 @@ class tuner {
     }
 
     configuration get_configuration() {
+      return get_configuration_ref();
+    }
+
+    // as "get_configuration", without copying: the returned configuration is reused by the next call
+    const configuration& get_configuration_ref() {
       bool write_header = false;
       if (!_is_stepping) {
         if (!_engine._silent)
+#ifdef LAZY_SEARCH_SPACE
+          std::cout << "\nsearch space size: at most " << _engine._search_space.num_configs() << std::endl << std::endl;
+#else
           std::cout << "\nsearch space size: " << _engine._search_space.num_configs() << std::endl << std::endl;
+#endif
         if (_log_file.empty())
-          _log_file = "tuning_log_" + atf::timestamp_str() + ".csv";
-        _stepping_log.open(_log_file, std::ofstream::out | std::ofstream::trunc);
-        _stepping_log.precision(std::numeric_limits<cost_t>::max_digits10);
-        _stepping_log << "timestamp;cost";
+          _log_file = "tuning_log_" + atf::timestamp_str() + (_log_format == log_format::binary ? ".atflog" : ".csv");
+        if (_log_format == log_format::binary) {
+          _stepping_columnar_log.open(_log_file);
+          _stepping_columnar_log.add_column("timestamp", detail::column_type::timestamp);
+          _stepping_columnar_log.add_column("cost", detail::column_type::float64);
+        } else {
+          _stepping_log.open(_log_file);
+          _stepping_log.precision(std::numeric_limits<cost_t>::max_digits10);
+          _stepping_log << "timestamp;cost";
+        }
         write_header = true;
+        if (!_trace_file.empty()) {
+          clear_trace();
+          start_tracing();
+        }
         _stepping_start = std::chrono::steady_clock::now();
         _is_stepping = true;
         _stepping_expects_report_cost = false;
@@ -143,20 +261,21 @@ class tuner {
       if (_stepping_expects_report_cost) {
         throw std::runtime_error("call to report_cost() expected");
       }
-      _stepping_config = _engine.get_next_config();
+      auto& next_config = _engine.get_next_config();
       _engine._status._number_of_evaluated_configs += 1;
       _stepping_expects_report_cost = true;
       // update tp values
-      for(auto& tp : _stepping_config) {
-        auto tp_value = tp.second;
-        tp_value.update_tp();
-      }
+      next_config.update_tps();
+      _stepping_config = &next_config.as_configuration();
       if (write_header) {
-        for (const auto &tp : _stepping_config) {
-          _stepping_log << ";" << tp.first;
+        for (const auto &tp : *_stepping_config) {
+          if (_stepping_columnar_log.is_open())
+            _stepping_columnar_log.add_column(tp.first, detail::column_type_of(tp.second.value().type_id()));
+          else
+            _stepping_log << ";" << tp.first;
         }
       }
-      return _stepping_config;
+      return *_stepping_config;
     }
 
     void report_cost(cost_t cost) {
@@ -168,15 +287,26 @@ class tuner {
       }
       _engine.report_result(cost);
       _stepping_expects_report_cost = false;
-      _stepping_log << std::endl << atf::timestamp_str() << ";" << cost;
-      for (const auto &tp : _stepping_config) {
-        _stepping_log << ";" << tp.second.value();
+      if (_stepping_columnar_log.is_open()) {
+        _stepping_columnar_log.append_timestamp(std::chrono::system_clock::now());
+        _stepping_columnar_log.append_float64(cost);
+        for (const auto &tp : *_stepping_config) {
+          _stepping_columnar_log.append_value(tp.second.value());
+        }
+        _stepping_columnar_log.end_row();
+      } else {
+        _stepping_log << '\n';
+        _stepping_log.timestamp() << ";" << cost;
+        for (const auto &tp : *_stepping_config) {
+          _stepping_log << ";" << tp.second.value();
+        }
+        _stepping_log.flush();
       }
       auto current_best_result = std::get<2>( _engine._status._history.back() );
       if (cost < current_best_result) {
         _engine._status._evaluations_required_to_find_best_found_result = _engine._status._number_of_evaluated_configs;
         _engine._status._history.emplace_back( std::chrono::steady_clock::now(),
-                                               _stepping_config,
+                                               *_stepping_config,
                                                cost
         );
       }
@@ -186,9 +316,9 @@ class tuner {
 
     template<typename cf_t>
     cost_t make_step(cf_t& cf) {
-        auto config = get_configuration();
+        get_configuration_ref();
         auto internal_cf = to_internal_type(cf);
-        auto cost = internal_cf(config);
+        auto cost = detail::call_cost_function(internal_cf, _engine._config_buffer, *_stepping_config, 0);
         report_cost(cost);
         return cost;
     }
@@ -203,12 +333,15 @@ class tuner {
   private:
     exploration_engine _engine;
     std::string _log_file;
+    atf::log_format _log_format = atf::log_format::csv;
+    std::string _trace_file;
 
     bool                                       _is_stepping = false;
     bool                                       _stepping_expects_report_cost;
-    configuration                              _stepping_config;
+    configuration*                             _stepping_config = nullptr; // string-keyed view of the engine's configuration buffer
     decltype(std::chrono::steady_clock::now()) _stepping_start;
-    std::ofstream                              _stepping_log;
+    detail::log_writer                         _stepping_log;
+    detail::columnar_log_writer                _stepping_columnar_log;
 };
 
 // helper
@@ -329,6 +462,25 @@ class cost_function_class {
       return *this;
     }
 
+    // the run script runs in its own process group, which is killed (and the configuration counted as invalid) once "timeout" is exceeded
+    cost_function_class& timeout(const timeout_class &timeout) {
+      _timeout = timeout;
+      return *this;
+    }
+
+    // stops the runs of a configuration once they show that it cannot beat the best configuration; without costfile, a run is
+    // killed once its runtime (i.e., its cost) cannot beat the best configuration's anymore
+    cost_function_class& racing(const racing_class &racing) {
+      _racing = racing;
+      return *this;
+    }
+
+    // repeats the run script per configuration according to "measurement" (e.g., until a confidence target is met)
+    cost_function_class& measurement(const measurement_class &measurement) {
+      _measurement = measurement;
+      return *this;
+    }
+
     inline auto to_internal_type() {
       return [=, *this](configuration &configuration) {
         // concat configuration values
@@ -339,34 +491,64 @@ class cost_function_class {
 
         // execute compile script if defined
         if (!_compile_script.empty()) {
-          auto ret = system((ss.str() + _compile_script).c_str());
+          int ret;
+          {
+            trace_span span( "run compile script", "generic" );
+            ret = detail::run_command_with_timeout(ss.str() + _compile_script, atf::timeout());
+          }
           if (ret != 0) {
             throw std::exception();
           }
         }
 
-        // execute run script
-        auto start = std::chrono::steady_clock::now();
-        auto ret = system((ss.str() + _run_script).c_str());
-        auto end = std::chrono::steady_clock::now();
-        if (ret != 0) {
-          throw std::exception();
-        }
-        size_t cost = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
-
-        // read cost from file if defined
-        if (!_costfile.empty()) {
-          std::ifstream cost_in;
-          cost_in.open(_costfile, std::ifstream::in);
-          ss.clear();
-          cost = std::numeric_limits<size_t>::max();
-          if (!(cost_in >> cost)) {
-            std::cerr << "could not read runtime from costfile: " << strerror(errno) << std::endl;
-            exit(EXIT_FAILURE);
+        // execute run script, repeated according to the measurement policy
+        bool killed = false;
+        double run_ms = 0;
+        size_t runs = 0;
+        auto run = [&]() -> double {
+          double race_limit_ms = _costfile.empty() ? _racing.limit() / 1000000 : std::numeric_limits<double>::infinity();
+          auto start = std::chrono::steady_clock::now();
+          int ret;
+          {
+            trace_span span( "run script", "generic" );
+            ret = detail::run_command_with_timeout(ss.str() + _run_script, _timeout, race_limit_ms, killed);
           }
-          cost_in.close();
+          auto end = std::chrono::steady_clock::now();
+          if (ret != 0) {
+            throw std::exception();
+          }
+          run_ms += std::chrono::duration<double, std::milli>(end - start).count();
+          ++runs;
+          size_t cost = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+          // read cost from file if defined (the runtime of a killed run is a lower bound of its cost)
+          if (!_costfile.empty() && !killed) {
+            trace_span span( "read cost file", "generic" );
+            std::ifstream cost_in;
+            cost_in.open(_costfile, std::ifstream::in);
+            ss.clear();
+            cost = std::numeric_limits<size_t>::max();
+            if (!(cost_in >> cost)) {
+              std::cerr << "could not read runtime from costfile: " << strerror(errno) << std::endl;
+              exit(EXIT_FAILURE);
+            }
+            cost_in.close();
+          }
+          return cost;
+        };
+
+        bool stopped = false;
+        cost_t cost = _measurement.measure_until(run, [&](double partial_cost, size_t repetitions, size_t max_repetitions) {
+          return stopped = killed || _racing.stop(partial_cost, repetitions, max_repetitions);
+        });
+        if (killed) {
+          _racing.report_stop();
         }
-
+        if (stopped) {
+          return _racing.stopped_cost(cost);
+        }
+        _timeout.report(cost, run_ms / runs);
+        _racing.report(cost);
         return cost;
       };
     }
@@ -374,6 +556,9 @@ class cost_function_class {
     std::string _run_script;
     std::string _compile_script;
     std::string _costfile;
+    timeout_class _timeout = atf::timeout();
+    racing_class _racing = no_racing();
+    measurement_class _measurement;
 };
 
 auto cost_function(const std::string &run_script) {
@@ -458,8 +643,21 @@ class cost_function_class {
       return *this;
     }
 
+    // shorthand for a fixed number of repetitions of the measurement policy
     cost_function_class<Ts...>& evaluations(size_t evaluations) {
-      _evaluations = evaluations;
+      _measurement.repetitions(evaluations, evaluations);
+      return *this;
+    }
+
+    // repeats the evaluations of a configuration according to "measurement" (e.g., until a confidence target is met)
+    cost_function_class<Ts...>& measurement(const measurement_class &measurement) {
+      _measurement = measurement;
+      return *this;
+    }
+
+    // stops the evaluations of a configuration once they show that it cannot beat the best configuration
+    cost_function_class<Ts...>& racing(const racing_class &racing) {
+      _racing = racing;
       return *this;
     }
 
@@ -481,7 +679,8 @@ class cost_function_class {
     std::tuple<tp_int_expression, tp_int_expression, tp_int_expression> _global_size{1, 1, 1};
     std::tuple<tp_int_expression, tp_int_expression, tp_int_expression> _local_size{1, 1, 1};
     size_t _warmups = 0;
-    size_t _evaluations = 1;
+    measurement_class _measurement;
+    racing_class _racing = no_racing();
 
     template<size_t... Is>
     inline auto to_internal_type_impl(std::index_sequence<Is...>) {
@@ -495,7 +694,8 @@ class cost_function_class {
           _local_size
       };
       internal_type_object.warm_ups(_warmups);
-      internal_type_object.evaluations(_evaluations);
+      internal_type_object.measurement(_measurement);
+      internal_type_object.racing(_racing);
       bool calls_all_gold_callable = std::any_of(_check_type.begin(), _check_type.end(), [](auto t) {return t == 3;});
       if (calls_all_gold_callable) {
         _all_gold_callable_results = std::make_tuple(
@@ -655,8 +855,21 @@ class cost_function_class {
       return *this;
     }
 
+    // shorthand for a fixed number of repetitions of the measurement policy
     cost_function_class<Ts...>& evaluations(size_t evaluations) {
-      _evaluations = evaluations;
+      _measurement.repetitions(evaluations, evaluations);
+      return *this;
+    }
+
+    // repeats the evaluations of a configuration according to "measurement" (e.g., until a confidence target is met)
+    cost_function_class<Ts...>& measurement(const measurement_class &measurement) {
+      _measurement = measurement;
+      return *this;
+    }
+
+    // stops the evaluations of a configuration once they show that it cannot beat the best configuration
+    cost_function_class<Ts...>& racing(const racing_class &racing) {
+      _racing = racing;
       return *this;
     }
 
@@ -677,7 +890,8 @@ class cost_function_class {
     std::tuple<tp_int_expression, tp_int_expression, tp_int_expression> _grid_dim{1, 1, 1};
     std::tuple<tp_int_expression, tp_int_expression, tp_int_expression> _block_dim{1, 1, 1};
     size_t _warmups = 0;
-    size_t _evaluations = 1;
+    measurement_class _measurement;
+    racing_class _racing = no_racing();
 
     template<size_t... Is>
     inline auto to_internal_type_impl(std::index_sequence<Is...>) {
@@ -691,7 +905,8 @@ class cost_function_class {
           _block_dim
       };
       internal_type_object.warm_ups(_warmups);
-      internal_type_object.evaluations(_evaluations);
+      internal_type_object.measurement(_measurement);
+      internal_type_object.racing(_racing);
       bool calls_all_gold_callable = std::any_of(_check_type.begin(), _check_type.end(), [](auto t) {return t == 3;});
       if (calls_all_gold_callable) {
         _all_gold_callable_results = std::make_tuple(
@@ -4,6 +4,8 @@
 
 
 #include <chrono>
+#include <deque>
+#include <utility>
 #include <vector>
 #include <memory>
 #include <iostream>
@@ -241,6 +243,53 @@ class result : public abort_condition
 };
 
 
+// stops once the hypervolume of the Pareto front w.r.t. "reference" (see "pareto_archive::hypervolume") reaches "target"
+class hypervolume : public abort_condition
+{
+  public:
+    hypervolume( const objective_vector& reference, double target )
+      : _reference( reference ), _target( target )
+    {}
+
+    bool stop( const tuning_status& status )
+    {
+      return status.pareto_front().hypervolume( _reference ) >= _target;
+    }
+  private:
+    objective_vector _reference;
+    double           _target;
+};
+
+
+// stops once the hypervolume of the Pareto front w.r.t. "reference" has grown by at most the fraction "improvement" within the
+// last "num_evaluations" evaluations
+class hypervolume_improvement : public abort_condition
+{
+  public:
+    hypervolume_improvement( const objective_vector& reference, double improvement, size_t num_evaluations )
+      : _reference( reference ), _improvement( improvement ), _num_evaluations( num_evaluations ), _history()
+    {}
+
+    bool stop( const tuning_status& status )
+    {
+      const size_t evaluations = status.number_of_evaluated_configs();
+      if( _history.empty() || _history.back().first != evaluations )
+        _history.emplace_back( evaluations, status.pareto_front().hypervolume( _reference ) );
+
+      // hypervolume "num_evaluations" evaluations ago
+      while( _history.size() > 1 && _history[ 1 ].first + _num_evaluations <= evaluations )
+        _history.pop_front();
+      if( _history.front().first + _num_evaluations > evaluations )
+        return false;
+
+      return _history.back().second <= _history.front().second * ( 1 + _improvement );
+    }
+  private:
+    objective_vector                          _reference;
+    double                                    _improvement;
+    size_t                                    _num_evaluations;
+    std::deque< std::pair<size_t, double> >   _history; // evaluations, hypervolume
+};
 
 
 } // namespace "cond"
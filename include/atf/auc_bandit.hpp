@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "search_technique.hpp"
+#include "detail/technique_state.hpp"
 
 namespace atf
 {
@@ -61,6 +62,13 @@ public:
     }
 
 
+    // objectives are reported to the technique whose costs follow
+    void report_objectives( const std::map<coordinates, objective_vector>& objectives ) override
+    {
+      report_objectives_impl( objectives, std::make_index_sequence<sizeof...(Ts)>{} );
+    }
+
+
     void report_costs( const std::map<coordinates, cost_t>& costs ) override
     {
       report_costs_impl( costs, std::make_index_sequence<sizeof...(Ts)>{} );
@@ -86,6 +94,44 @@ public:
     }
 
 
+    void save_state( std::ostream& out ) const override
+    {
+      detail::save_value( out, _rand_generator );
+      detail::save_value( out, _current_technique_index );
+      detail::save_value( out, _current_best_cost );
+      detail::save_value( out, _history.size() );
+      for( const auto& entry : _history )
+      {
+        detail::save_value( out, entry.technique_index );
+        detail::save_value( out, entry.cost_has_improved );
+      }
+      detail::save_value( out, _uses );
+      detail::save_value( out, _raw_auc );
+      detail::save_value( out, _decay );
+      save_state_impl( out, std::make_index_sequence<sizeof...(Ts)>{} );
+    }
+
+
+    void load_state( std::istream& in ) override
+    {
+      size_t history_size;
+      detail::load_value( in, _rand_generator );
+      detail::load_value( in, _current_technique_index );
+      detail::load_value( in, _current_best_cost );
+      detail::load_value( in, history_size );
+      _history.resize( history_size );
+      for( auto& entry : _history )
+      {
+        detail::load_value( in, entry.technique_index );
+        detail::load_value( in, entry.cost_has_improved );
+      }
+      detail::load_value( in, _uses );
+      detail::load_value( in, _raw_auc );
+      detail::load_value( in, _decay );
+      load_state_impl( in, std::make_index_sequence<sizeof...(Ts)>{} );
+    }
+
+
 private:
     std::ofstream _log_file;
 
@@ -183,7 +229,7 @@ private:
         technique.initialize( dimensionality );
         initialize_impl( dimensionality, techniques... );
     }
-    void initialize_impl( size_t dimensionality ) {
+    void initialize_impl( size_t /* dimensionality */ ) {
     }
 
     template<size_t... Is>
@@ -197,7 +243,7 @@ private:
         else
             return get_next_coordinates_impl( index + 1, techniques... );
     }
-    std::set<coordinates> get_next_coordinates_impl(size_t index) {
+    std::set<coordinates> get_next_coordinates_impl(size_t /* index */) {
         assert(false && "should never be reached");
 
         return {};
@@ -214,7 +260,22 @@ private:
         else
             report_costs_impl( costs, index + 1, techniques... );
     }
-    void report_costs_impl(const std::map<coordinates, cost_t>& costs, size_t index) {
+    void report_costs_impl(const std::map<coordinates, cost_t>& /* costs */, size_t /* index */) {
+        assert(false && "should never be reached");
+    }
+
+    template<size_t... Is>
+    void report_objectives_impl(const std::map<coordinates, objective_vector>& objectives, std::index_sequence<Is...> ) {
+        report_objectives_impl( objectives, 0, std::get<Is>(_techniques)... );
+    }
+    template<typename T, typename... ARGS>
+    void report_objectives_impl(const std::map<coordinates, objective_vector>& objectives, size_t index, T& technique, ARGS&... techniques ) {
+        if (index == _current_technique_index)
+            technique.report_objectives(objectives);
+        else
+            report_objectives_impl( objectives, index + 1, techniques... );
+    }
+    void report_objectives_impl(const std::map<coordinates, objective_vector>& /* objectives */, size_t /* index */) {
         assert(false && "should never be reached");
     }
 
@@ -229,6 +290,30 @@ private:
     }
     void finalize_impl() {
     }
+
+    template<size_t... Is>
+    void save_state_impl( std::ostream& out, std::index_sequence<Is...> ) const {
+        save_state_impl( out, std::get<Is>(_techniques)... );
+    }
+    template<typename T, typename... ARGS>
+    void save_state_impl( std::ostream& out, const T& technique, const ARGS&... techniques ) const {
+        technique.save_state( out );
+        save_state_impl( out, techniques... );
+    }
+    void save_state_impl( std::ostream& /* out */ ) const {
+    }
+
+    template<size_t... Is>
+    void load_state_impl( std::istream& in, std::index_sequence<Is...> ) {
+        load_state_impl( in, std::get<Is>(_techniques)... );
+    }
+    template<typename T, typename... ARGS>
+    void load_state_impl( std::istream& in, T& technique, ARGS&... techniques ) {
+        technique.load_state( in );
+        load_state_impl( in, techniques... );
+    }
+    void load_state_impl( std::istream& /* in */ ) {
+    }
 };
 
 template<typename... Ts>
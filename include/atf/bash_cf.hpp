@@ -1,41 +1,80 @@
 #ifndef bash_cf_h
 #define bash_cf_h
 
+#include <cstdio>
 #include <cstring>
+#include <atomic>
+#include <stdexcept>
 #include <string>
 #include <sstream>
 #include <fstream>
 #include <chrono>
 #include <iostream>
 
+#include "isolation.hpp"
+#include "trace.hpp"
+
 namespace atf
 {
 
+namespace detail
+{
+
+// path of the cost file of one evaluation of "cf::bash": "costfile" with a suffix that is unique within the process, such that
+// evaluations on several threads (see "tuner::evaluation_threads") do not overwrite each other's costs
+inline std::string evaluation_costfile( const std::string& costfile )
+{
+  static std::atomic<size_t> next_id( 0 );
+  return costfile + "." + std::to_string( next_id++ );
+}
+
+} // namespace detail
+
+
 namespace cf
 {
 
-auto bash(const std::string &script, const std::string &costfile) {
+// The script runs in its own process group, which is killed (and the configuration counted as invalid) once "timeout" is exceeded.
+// The path of the evaluation's own cost file is passed to the script as environment variable "ATF_COSTFILE"; scripts that write
+// their cost to "costfile" instead support sequential evaluations only.
+auto bash(const std::string &script, const std::string &costfile, const timeout_class &timeout = atf::timeout()) {
   return [=](configuration &configuration) {
+      const std::string own_costfile = detail::evaluation_costfile(costfile);
       std::stringstream ss;
+      ss << "ATF_COSTFILE='" << own_costfile << "' ";
       for (auto &tp : configuration) {
         ss << tp.first << "=" << tp.second << " ";
       }
       ss << script;
-      auto ret = system(ss.str().c_str());
+      auto start = std::chrono::steady_clock::now();
+      int ret;
+      {
+        trace_span span( "run script", "bash" );
+        ret = detail::run_command_with_timeout(ss.str(), timeout);
+      }
+      auto end = std::chrono::steady_clock::now();
       if (ret != 0) {
+        std::remove(own_costfile.c_str());
         throw std::exception();
       }
 
-      std::ifstream cost_in;
-      cost_in.open(costfile, std::ifstream::in);
-      size_t runtime = 0;
-      ss.clear();
-      if (!(cost_in >> runtime)) {
-        std::cerr << "could not read runtime from costfile: " << strerror(errno) << std::endl;
-        exit(EXIT_FAILURE);
+      trace_span span( "read cost file", "bash" );
+      std::ifstream cost_in(own_costfile, std::ifstream::in);
+      const bool has_own_costfile = cost_in.is_open();
+      if (!has_own_costfile) {
+        cost_in.open(costfile, std::ifstream::in);
       }
+      size_t runtime = 0;
+      const bool read = static_cast<bool>(cost_in >> runtime);
       cost_in.close();
-   
+      if (has_own_costfile) {
+        std::remove(own_costfile.c_str());
+      }
+      if (!read) {
+        throw std::runtime_error("could not read cost from costfile: " + (has_own_costfile ? own_costfile : costfile));
+      }
+
+      timeout.report(runtime, std::chrono::duration<double, std::milli>(end - start).count());
       return runtime;
   };
 }
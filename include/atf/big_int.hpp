@@ -85,6 +85,9 @@ public:
     explicit operator unsigned int() const;
     explicit operator unsigned long() const;
     explicit operator unsigned long long() const;
+#ifdef __SIZEOF_INT128__
+    explicit operator unsigned __int128() const;
+#endif
     explicit operator std::string() const;
 
     // arithmetic operators
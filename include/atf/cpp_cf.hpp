@@ -4,6 +4,8 @@
 
 #include <chrono>
 
+#include "trace.hpp"
+
 namespace atf
 {
 
@@ -12,6 +14,7 @@ auto cpp( Ts&&... args ) {
     return [&](atf::configuration &config) -> cost_t {
         auto tunable = T(config);
 
+        trace_span span( "run tunable", "cpp" );
         auto start = std::chrono::steady_clock::now();
 
         tunable( args... );
@@ -21,6 +21,9 @@
 
 #include "tp_value.hpp"
 #include "helper.hpp"
+#include "racing.hpp"
+#include "measurement.hpp"
+#include "trace.hpp"
 
 using namespace std::literals::string_literals;
 
@@ -127,8 +130,17 @@ class cuda_wrapper
       m_Warmups = warm_ups;
     }
 
+    // Shorthand for a fixed number of repetitions of the measurement policy
     void evaluations(size_t evaluations) {
-      m_Evaluations = evaluations;
+      m_Measurement.repetitions(evaluations, evaluations);
+    }
+
+    void measurement(const measurement_class& measurement) {
+      m_Measurement = measurement;
+    }
+
+    void racing(const racing_class& racing) {
+      m_Racing = racing;
     }
 
 
@@ -139,8 +151,24 @@ class cuda_wrapper
       std::get<index>(m_CheckResult) = true;
     }
 
+    // PTX compiled for a configuration by "compile", to be run by "measure"
+    struct compiled_kernel
+    {
+      ::std::vector<char> ptx;
+      int                 grid_dim[3];
+      int                 block_dim[3];
+    };
+
     auto operator()(configuration& p_cfg)
     -> return_type
+    {
+      auto t_compiled = this->compile(p_cfg);
+      return this->measure(t_compiled);
+    }
+
+    // Compiles the kernel for a configuration; the compilation of a configuration may overlap the measurement of another
+    auto compile(configuration& p_cfg)
+    -> compiled_kernel
     {
       // Update tuning parameters
       this->update_tps(p_cfg);
@@ -148,38 +176,61 @@ class cuda_wrapper
       // Compile kernel
       this->compile_kernel(p_cfg);
 
-      // Run kernel
-      return this->run_kernel();
+      // Retrieve PTX
+      compiled_kernel t_compiled;
+
+      size_t t_ptxSize;
+      nvrtc_safe_call<>(nvrtcGetPTXSize(m_Program, &t_ptxSize), "Failed to retrieve PTX size");
+
+      t_compiled.ptx.resize(t_ptxSize);
+      nvrtc_safe_call<>(nvrtcGetPTX(m_Program, t_compiled.ptx.data()), "Failed to retrieve PTX code");
+
+      // Retrieve grid and block dimensions
+      t_compiled.grid_dim[0] = (int) std::get<0>(m_GridDimensions).evaluate();
+      t_compiled.grid_dim[1] = (int) std::get<1>(m_GridDimensions).evaluate();
+      t_compiled.grid_dim[2] = (int) std::get<2>(m_GridDimensions).evaluate();
+
+      t_compiled.block_dim[0] = (int) std::get<0>(m_BlockDimensions).evaluate();
+      t_compiled.block_dim[1] = (int) std::get<1>(m_BlockDimensions).evaluate();
+      t_compiled.block_dim[2] = (int) std::get<2>(m_BlockDimensions).evaluate();
+
+      return t_compiled;
+    }
+
+    // Runs a compiled kernel and returns its runtime in ns
+    auto measure(compiled_kernel& p_compiled)
+    -> return_type
+    {
+      // The measuring thread may differ from the thread that created the context
+      cuda_safe_call<>(cuCtxSetCurrent(m_Context), "Failed to set context");
+
+      return this->run_kernel(p_compiled);
     }
 
   private:
     size_t buffer_pos = 0;
 
-    auto run_kernel()
+    auto run_kernel(compiled_kernel& p_compiled)
     -> return_type
     {
-      // Retrieve PTX
-      size_t t_ptxSize;
-      nvrtc_safe_call<>(nvrtcGetPTXSize(m_Program, &t_ptxSize), "Failed to retrieve PTX size");
-
-      ::std::vector<char> t_ptxCode(t_ptxSize);
-      nvrtc_safe_call<>(nvrtcGetPTX(m_Program, t_ptxCode.data()), "Failed to retrieve PTX code");
-
       // Load PTX
       CUmodule t_module;
       CUfunction t_kernel;
 
-      cuda_safe_call<>(cuModuleLoadDataEx(&t_module, t_ptxCode.data(), 0, 0, 0), "Failed to load module data");
-      cuda_safe_call<>(cuModuleGetFunction(&t_kernel, t_module, m_KernelName.c_str()), "Failed to retrieve kernel handle");
+      {
+        trace_span span( "load module", "cuda" );
+        cuda_safe_call<>(cuModuleLoadDataEx(&t_module, p_compiled.ptx.data(), 0, 0, 0), "Failed to load module data");
+        cuda_safe_call<>(cuModuleGetFunction(&t_kernel, t_module, m_KernelName.c_str()), "Failed to retrieve kernel handle");
+      }
 
-      // Retrieve grid and block dimensions
-      const int gd0 = (int) std::get<0>(m_GridDimensions).evaluate();
-      const int gd1 = (int) std::get<1>(m_GridDimensions).evaluate();
-      const int gd2 = (int) std::get<2>(m_GridDimensions).evaluate();
+      // Grid and block dimensions
+      const int gd0 = p_compiled.grid_dim[0];
+      const int gd1 = p_compiled.grid_dim[1];
+      const int gd2 = p_compiled.grid_dim[2];
 
-      const int bd0 = (int) std::get<0>(m_BlockDimensions).evaluate();
-      const int bd1 = (int) std::get<1>(m_BlockDimensions).evaluate();
-      const int bd2 = (int) std::get<2>(m_BlockDimensions).evaluate();
+      const int bd0 = p_compiled.block_dim[0];
+      const int bd1 = p_compiled.block_dim[1];
+      const int bd2 = p_compiled.block_dim[2];
 
       // warm ups
       for( size_t i = 0 ; i < m_Warmups ; ++i )
@@ -188,6 +239,7 @@ class cuda_wrapper
         this->fill_buffers(false);
 
         // Launch kernel
+        trace_span span( "launch warm up", "cuda" );
         const auto t_kernelResult = cuLaunchKernel(
             t_kernel,
             gd0, gd1, gd2,
@@ -206,9 +258,8 @@ class cuda_wrapper
         }
       }
 
-      // evaluations
-      float t_runtimeInMs = 0;
-      for( size_t i = 0 ; i < m_Evaluations ; ++i )
+      // evaluations, repeated according to the measurement policy (and stopped if the configuration cannot beat the best one)
+      auto t_runKernel = [&]() -> double
       {
         // Create benchmark events
         cudaEvent_t t_start, t_stop;
@@ -219,6 +270,7 @@ class cuda_wrapper
         this->fill_buffers(false);
 
         // Launch kernel
+        trace_span span( "run kernel", "cuda" );
         cuda_safe_call<>(cudaEventRecord(t_start, 0), "Failed to record start event");
         const auto t_kernelResult = cuLaunchKernel(
             t_kernel,
@@ -243,17 +295,19 @@ class cuda_wrapper
 
         cuda_safe_call<>(cudaEventSynchronize(t_stop), "Failed to synchronize events");
         cuda_safe_call<>(cudaEventElapsedTime(&tmp, t_start, t_stop), "Failed to retrieve elapsed time");
-        t_runtimeInMs += tmp;
 
         cuda_safe_call<>(cudaEventDestroy(t_start), "Failed to destroy events");
         cuda_safe_call<>(cudaEventDestroy(t_stop), "Failed to destroy events");
-      }
+
+        return static_cast<double>(tmp) * 1000000;
+      };
+      const auto t_runtimeInNs = static_cast<return_type>(m_Measurement.measure(t_runKernel, m_Racing));
 
       // check result
       if( std::any_of(m_CheckResult.begin(), m_CheckResult.end(), [](auto b) { return b; }) )
         check_result_helper( std::make_index_sequence<sizeof...(Ts)>() );
 
-      return static_cast<return_type>(t_runtimeInMs * 1000000 / m_Evaluations);
+      return t_runtimeInNs;
     }
 
     auto compile_kernel(configuration& p_cfg)
@@ -265,6 +319,7 @@ class cuda_wrapper
       this->create_flags(p_cfg, t_flags, t_views);
 
       // Compile kernel
+      trace_span span( "compile kernel", "cuda" );
       const auto t_result = nvrtcCompileProgram(
           m_Program,
           static_cast<int>(t_flags.size()),
@@ -409,6 +464,7 @@ class cuda_wrapper
     template< size_t... Is >
     void fill_buffers(bool init, std::index_sequence<Is...>)
     {
+      trace_span span( "fill buffers", "cuda" );
       buffer_pos = 0;
       fill_buffers_impl(init, std::get<Is>(m_KernelInputs)...);
     }
@@ -449,6 +505,7 @@ class cuda_wrapper
     template< size_t... Is >
     void check_result_helper( std::index_sequence<Is...> )
     {
+      trace_span span( "check result", "cuda" );
       buffer_pos = 0;
       check_result_helper_impl( std::make_tuple( std::get<Is>( m_CheckResult ) ,
                                                  std::cref(std::get<Is>( m_KernelInputs )) ,
@@ -522,7 +579,8 @@ class cuda_wrapper
 
     // --- Kernel data
     size_t          m_Warmups = 0;
-    size_t          m_Evaluations = 1;
+    measurement_class m_Measurement;
+    racing_class    m_Racing = ::atf::no_racing();
     ::std::string   m_KernelSource;
     ::std::string   m_KernelName;
     ::std::string   m_KernelFlags;
@@ -190,6 +190,22 @@ big_int::operator unsigned long long() const {
         throw big_int_exception(e.what());
     }
 }
+#ifdef __SIZEOF_INT128__
+// composed from the decimal digits, without converting to a string
+template<>
+big_int::operator unsigned __int128() const {
+    if (_backend < 0 || _backend.numberOfDigits() > 39)
+        throw big_int_exception("out of bounds");
+    unsigned __int128 value = 0;
+    for (size_t i = _backend.numberOfDigits(); i-- > 0;) {
+        const unsigned digit = static_cast<unsigned>(_backend.digitAt(i));
+        if (value > (~static_cast<unsigned __int128>(0) - digit) / 10)
+            throw big_int_exception("out of bounds");
+        value = value * 10 + digit;
+    }
+    return value;
+}
+#endif
 template<>
 big_int::operator std::string() const {
     return _backend.toString();
@@ -0,0 +1,83 @@
+#ifndef binary_io_h
+#define binary_io_h
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace atf
+{
+
+namespace detail
+{
+
+// Items of ATF's binary files (search space files, tuning databases, binary tuning logs) are padded to 8 bytes, such that
+// every item starts at an 8-byte boundary; integers are stored as 64-bit values, strings as their size followed by their bytes.
+inline size_t padded_size( size_t size )
+{
+  return ( size + 7 ) / 8 * 8;
+}
+
+
+inline void write_bytes( std::ostream& out, const void* data, size_t size )
+{
+  static const char padding[ 8 ] = {};
+  out.write( static_cast<const char*>( data ), size );
+  out.write( padding, padded_size( size ) - size );
+}
+
+inline void write_bytes( std::string& out, const void* data, size_t size )
+{
+  static const char padding[ 8 ] = {};
+  out.append( static_cast<const char*>( data ), size );
+  out.append( padding, padded_size( size ) - size );
+}
+
+template< typename sink_t >
+void write_uint64( sink_t& out, std::uint64_t value )
+{
+  write_bytes( out, &value, sizeof( value ) );
+}
+
+template< typename sink_t >
+void write_string( sink_t& out, const std::string& str )
+{
+  write_uint64( out, str.size() );
+  write_bytes( out, str.data(), str.size() );
+}
+
+
+// the read functions return false (or an empty string) if the file ends before the item does
+inline bool read_bytes( std::istream& in, void* data, size_t size )
+{
+  char padding[ 8 ];
+  in.read( static_cast<char*>( data ), size );
+  in.read( padding, padded_size( size ) - size );
+  return in.good();
+}
+
+inline bool read_uint64( std::istream& in, std::uint64_t& value )
+{
+  return read_bytes( in, &value, sizeof( value ) );
+}
+
+// strings are at most "max_size" bytes long
+inline std::string read_string( std::istream& in, std::uint64_t max_size = 1u << 20 )
+{
+  std::uint64_t size;
+  if( !read_uint64( in, size ) || size > max_size )
+    return std::string();
+
+  std::string str( static_cast<size_t>( size ), '\0' );
+  if( size > 0 && !read_bytes( in, &str[ 0 ], str.size() ) )
+    return std::string();
+
+  return str;
+}
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* binary_io_h */
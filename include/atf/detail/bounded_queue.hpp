@@ -0,0 +1,71 @@
+#ifndef bounded_queue_h
+#define bounded_queue_h
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+namespace atf
+{
+
+namespace detail
+{
+
+// Queue between two pipeline stages: "push" blocks while the queue is full, "pop" blocks while it is empty. Waiting stages
+// sleep instead of spinning, such that they do not disturb measurements on the same machine.
+template< typename T >
+class bounded_queue
+{
+  public:
+    explicit bounded_queue( size_t capacity )
+      : _capacity( capacity ), _elements(), _closed( false ), _mutex(), _not_empty(), _not_full()
+    {}
+
+    void push( const T& element )
+    {
+      std::unique_lock<std::mutex> lock( _mutex );
+      _not_full.wait( lock, [ & ]() { return _elements.size() < _capacity; } );
+      _elements.push_back( element );
+      lock.unlock();
+      _not_empty.notify_one();
+    }
+
+    // returns false if the queue is closed and empty
+    bool pop( T& element )
+    {
+      std::unique_lock<std::mutex> lock( _mutex );
+      _not_empty.wait( lock, [ & ]() { return _closed || !_elements.empty(); } );
+      if( _elements.empty() )
+        return false;
+
+      element = _elements.front();
+      _elements.pop_front();
+      lock.unlock();
+      _not_full.notify_one();
+      return true;
+    }
+
+    // wakes up the consumer once the remaining elements have been popped
+    void close()
+    {
+      {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _closed = true;
+      }
+      _not_empty.notify_all();
+    }
+
+  private:
+    const size_t             _capacity;
+    std::deque< T >          _elements;
+    bool                     _closed;
+    std::mutex               _mutex;
+    std::condition_variable  _not_empty;
+    std::condition_variable  _not_full;
+};
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* bounded_queue_h */
@@ -0,0 +1,300 @@
+#ifndef candidate_values_h
+#define candidate_values_h
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <string>
+
+#include "utility.hpp"
+
+namespace atf
+{
+
+namespace detail
+{
+
+// Superset of the values fulfilling a structured predicate (see "predicates.hpp"): the predicates narrow the candidates
+// to bounds, to the divisors of a number and/or to the multiples of a number, such that the values of an integer
+// interval can be enumerated in closed form instead of evaluating the predicate for each value of the interval.
+template< typename T >
+struct candidate_values
+{
+  T    min          = std::numeric_limits<T>::min();
+  T    max          = std::numeric_limits<T>::max();
+  T    divisors_of  = 0; // 0: no restriction
+  T    multiples_of = 0; // 0: no restriction
+  bool empty        = false;
+  bool narrowed     = false;
+};
+
+
+// value of "M" in predicates: a number, a TP or an expression of TPs
+template< typename V, std::enable_if_t<( std::is_arithmetic<V>::value )>* = nullptr >
+V numeric_value( const V& v )
+{
+  return v;
+}
+
+template< typename V, std::enable_if_t<( !std::is_arithmetic<V>::value )>* = nullptr >
+auto numeric_value( const V& v )
+{
+  return v.cast();
+}
+
+
+// converts "v" to "T"; returns false if "v" is no integer representable by "T"
+template< typename T, typename V >
+bool integral_value( const V& v, T& value )
+{
+  const auto m = numeric_value( v );
+  using M_t = std::decay_t<decltype( m )>;
+
+  if( !std::is_integral<T>::value || !std::is_integral<M_t>::value || std::is_same<M_t,bool>::value )
+    return false;
+
+  if( m < static_cast<M_t>( 0 ) )
+  {
+    if( std::is_unsigned<T>::value || static_cast<long long>( m ) < static_cast<long long>( std::numeric_limits<T>::min() ) )
+      return false;
+  }
+  else if( static_cast<unsigned long long>( m ) > static_cast<unsigned long long>( std::numeric_limits<T>::max() ) )
+    return false;
+
+  value = static_cast<T>( m );
+  return true;
+}
+
+
+template< typename T >
+T gcd( T a, T b )
+{
+  while( b != 0 )
+    a = std::exchange( b, a % b );
+
+  return a;
+}
+
+
+// calls "predicate.narrow( c )" if the predicate is structured
+template< typename P, typename T >
+auto narrow_candidates( const P& predicate, candidate_values<T>& c, int ) -> decltype( predicate.narrow( c ), void() )
+{
+  predicate.narrow( c );
+}
+
+template< typename P, typename T >
+void narrow_candidates( const P&, candidate_values<T>&, long )
+{}
+
+
+// Adds the parameters of a predicate (e.g., "M" of "divides( M )") to "hash", such that search space files are regenerated when
+// they change; TPs used as parameters are identified by their names. Returns false if the predicate has state that cannot be
+// hashed, e.g., the captures of a lambda.
+template< size_t N >
+struct hash_rank : hash_rank<N - 1> {};
+
+template<>
+struct hash_rank<0> {};
+
+template< typename hash_t, typename V, std::enable_if_t<( std::is_arithmetic<V>::value )>* = nullptr >
+bool hash_parameters( hash_t& hash, const V& v, hash_rank<3> )
+{
+  hash.add( &v, sizeof( v ) );
+  return true;
+}
+
+template< typename hash_t, typename P >
+auto hash_parameters( hash_t& hash, const P& p, hash_rank<2> ) -> decltype( p.hash_parameters( hash ) )
+{
+  return p.hash_parameters( hash );
+}
+
+template< typename hash_t, typename P >
+auto hash_parameters( hash_t& hash, const P& p, hash_rank<1> ) -> decltype( p.name(), bool() )
+{
+  hash.add( std::string( p.name() ) );
+  return true;
+}
+
+template< typename hash_t, typename P >
+bool hash_parameters( hash_t&, const P&, hash_rank<0> )
+{
+  return std::is_empty<P>::value;
+}
+
+template< typename hash_t, typename P >
+bool hash_parameters( hash_t& hash, const P& p )
+{
+  return hash_parameters( hash, p, hash_rank<3>() );
+}
+
+
+// records the names of the TPs among the parameters of a predicate (passed as "hash" to "hash_parameters")
+struct parameter_tp_names
+{
+  std::vector< std::string > names;
+
+  void add( const void*, size_t )
+  {}
+
+  void add( const std::string& name )
+  {
+    names.emplace_back( name );
+  }
+};
+
+
+// true iff the TPs read by predicate "P" are known from its parameters, i.e., "P" is one of ATF's structured predicates; other
+// callables may read arbitrary TPs, e.g., lambdas without captures that read TPs at namespace scope
+template< typename P, typename = void >
+struct provides_parameters : std::false_type {};
+
+template< typename P >
+struct provides_parameters< P, void_t<decltype( std::declval<const P&>().hash_parameters( std::declval<parameter_tp_names&>() ) )> > : std::true_type {};
+
+template< typename P >
+struct has_known_parameters : provides_parameters<P> {};
+
+
+template< typename P, typename T, typename = void >
+struct is_structured_predicate : std::false_type {};
+
+template< typename P, typename T >
+struct is_structured_predicate< P, T, void_t<decltype( std::declval<const P&>().narrow( std::declval<candidate_values<T>&>() ) )> > : std::true_type {};
+
+
+// Enumerates (in ascending order) the candidates within the integer interval "begin, begin + step_size, ..., end".
+template< typename T >
+class candidate_cursor
+{
+  public:
+    candidate_cursor()
+      : _begin(), _step_size(), _next(), _last(), _stride(), _done( true ), _divisors(), _pos( 0 )
+    {}
+
+
+    // returns false if "c" is not narrowed, i.e., all values of the interval have to be checked
+    bool start( T begin, T end, T step_size, const candidate_values<T>& c )
+    {
+      _done     = true;
+      _divisors.clear();
+      _pos      = 0;
+
+      if( !c.narrowed || step_size <= 0 )
+        return false;
+
+      const T lo = std::max( begin, c.min );
+      const T hi = std::min( end,   c.max );
+      if( c.empty || lo > hi )
+        return true;
+
+      _begin     = begin;
+      _step_size = step_size;
+      _last      = hi;
+      _done      = false;
+
+      if( c.divisors_of > 0 && lo >= 1 ) // negative divisors are enumerated by the remaining cases
+      {
+        // divisors by trial division up to the square root
+        std::vector<T> large_divisors;
+        for( T d = 1 ; d <= c.divisors_of / d ; ++d )
+        {
+          if( c.divisors_of % d != 0 )
+            continue;
+
+          if( d >= lo && d <= hi && on_interval( d ) && is_multiple( d, c.multiples_of ) )
+            _divisors.push_back( d );
+
+          const T co_divisor = c.divisors_of / d;
+          if( co_divisor != d && co_divisor >= lo && co_divisor <= hi && on_interval( co_divisor ) && is_multiple( co_divisor, c.multiples_of ) )
+            large_divisors.push_back( co_divisor );
+        }
+        _divisors.insert( _divisors.end(), large_divisors.rbegin(), large_divisors.rend() );
+        _stride = 0;
+      }
+      else if( c.multiples_of > 0 && lo >= 0 )
+      {
+        const T remainder = lo % c.multiples_of;
+        if( remainder != 0 && lo > std::numeric_limits<T>::max() - ( c.multiples_of - remainder ) )
+          _done = true;
+        else
+          _next = remainder == 0 ? lo : lo + ( c.multiples_of - remainder );
+        _stride = c.multiples_of;
+      }
+      else
+      {
+        // bounds only: first value of the interval not below "lo"
+        const T offset = static_cast<T>( distance( begin, lo ) % static_cast<std::make_unsigned_t<T>>( step_size ) );
+        if( offset != 0 && lo > std::numeric_limits<T>::max() - ( step_size - offset ) )
+          _done = true;
+        else
+          _next = offset == 0 ? lo : lo + ( step_size - offset );
+        _stride = step_size;
+      }
+
+      return true;
+    }
+
+
+    bool next( T& value )
+    {
+      if( _stride == 0 )
+      {
+        if( _pos == _divisors.size() )
+          return false;
+
+        value = _divisors[ _pos++ ];
+        return true;
+      }
+
+      while( !_done && _next <= _last )
+      {
+        value = _next;
+        if( distance( _next, _last ) < static_cast<std::make_unsigned_t<T>>( _stride ) )
+          _done = true;
+        else
+          _next += _stride;
+
+        if( on_interval( value ) )
+          return true;
+      }
+
+      _done = true;
+      return false;
+    }
+
+  private:
+    T              _begin;
+    T              _step_size;
+    T              _next;
+    T              _last;
+    T              _stride;    // 0: enumerates "_divisors"
+    bool           _done;
+    std::vector<T> _divisors;
+    size_t         _pos;
+
+    bool on_interval( T value ) const
+    {
+      return value >= _begin && distance( _begin, value ) % static_cast<std::make_unsigned_t<T>>( _step_size ) == 0;
+    }
+
+    // "to - from" for "from <= to", computed without overflowing "T" for wide intervals of signed integers
+    static auto distance( T from, T to )
+    {
+      return static_cast<std::make_unsigned_t<T>>( to ) - static_cast<std::make_unsigned_t<T>>( from );
+    }
+
+    static bool is_multiple( T value, T factor )
+    {
+      return factor == 0 || value % factor == 0;
+    }
+};
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* candidate_values_h */
@@ -0,0 +1,279 @@
+#ifndef columnar_log_h
+#define columnar_log_h
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "binary_io.hpp"
+#include "log_writer.hpp"
+#include "../value_type.hpp"
+
+namespace atf
+{
+
+enum class log_format { csv, binary };
+
+
+namespace detail
+{
+
+// types of the columns of a binary tuning log; values are stored with the width of their type
+enum class column_type : std::uint64_t { boolean, int32, uint64, float32, float64, string, timestamp };
+
+inline size_t column_width( column_type type )
+{
+  switch( type )
+  {
+    case column_type::boolean:   return 1;
+    case column_type::int32:     return 4;
+    case column_type::float32:   return 4;
+    case column_type::string:    return 4; // code in the column's dictionary
+    default:                     return 8;
+  }
+}
+
+inline column_type column_type_of( value_type::type_id_t type_id )
+{
+  switch( type_id )
+  {
+    case value_type::bool_t:     return column_type::boolean;
+    case value_type::int_t:      return column_type::int32;
+    case value_type::size_t_t:   return column_type::uint64;
+    case value_type::float_t:    return column_type::float32;
+    case value_type::double_t:   return column_type::float64;
+    case value_type::string_t:   return column_type::string;
+    default:                     throw std::runtime_error( "tuning parameter value has no column type" );
+  }
+}
+
+inline std::string columnar_log_magic()
+{
+  return "ATF columnar tuning log v1";
+}
+
+inline std::uint64_t columnar_log_chunk_marker()
+{
+  return 0x41544643484e4bull; // "ATFCHNK"
+}
+
+
+// Binary tuning log: a schema (the columns' names and types), followed by chunks of rows stored column by column. A chunk
+// holds the values of each column as an array of the column's type; strings are dictionary-encoded per column, and a chunk
+// holds the dictionary entries that first occur in it. Items are padded to 8 bytes (see "binary_io.hpp"). Chunks are handed
+// over to a "log_writer", such that the tuning loop does not wait for the disk; the rows of an incomplete chunk are written
+// when the log is closed.
+class columnar_log_writer
+{
+  public:
+    explicit columnar_log_writer( size_t chunk_rows = 4096 )
+      : _chunk_rows( chunk_rows ), _out(), _columns(), _num_rows( 0 ), _next_column( 0 ), _schema_written( false ), _chunk()
+    {}
+
+    columnar_log_writer( const columnar_log_writer& ) = delete;
+
+    ~columnar_log_writer()
+    {
+      close();
+    }
+
+
+    // "buffer_capacity" and "flush_interval": see "log_writer"
+    void open( const std::string& path, size_t buffer_capacity = 1 << 20, std::chrono::milliseconds flush_interval = std::chrono::milliseconds( 100 ) )
+    {
+      close();
+      _out.reset( new log_writer( buffer_capacity, flush_interval ) );
+      _out->open( path );
+      if( !*_out )
+        throw std::runtime_error( "cannot write tuning log: " + path );
+
+      _columns.clear();
+      _num_rows       = 0;
+      _next_column    = 0;
+      _schema_written = false;
+    }
+
+    bool is_open() const
+    {
+      return _out && _out->is_open();
+    }
+
+    // writes the rows of the incomplete chunk
+    void close()
+    {
+      if( !is_open() )
+        return;
+
+      write_chunk();
+      _out->close();
+    }
+
+
+    // columns are added before the first row
+    void add_column( const std::string& name, column_type type )
+    {
+      if( _schema_written || _num_rows > 0 || _next_column > 0 )
+        throw std::runtime_error( "columns of a tuning log must be added before its first row" );
+      _columns.push_back( column{ name, type, {}, {}, {} } );
+    }
+
+    size_t num_columns() const
+    {
+      return _columns.size();
+    }
+
+
+    // values of a row are appended in the order of the columns
+    void append_float64( double value )
+    {
+      append( column_type::float64, &value );
+    }
+
+    void append_uint64( std::uint64_t value )
+    {
+      append( column_type::uint64, &value );
+    }
+
+    void append_timestamp( std::chrono::system_clock::time_point time_point )
+    {
+      const std::int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>( time_point.time_since_epoch() ).count();
+      append( column_type::timestamp, &ns );
+    }
+
+    void append_value( const value_type& value )
+    {
+      switch( value.type_id() )
+      {
+        case value_type::bool_t:   { const std::uint8_t v = static_cast<bool>( value );  append( column_type::boolean, &v ); break; }
+        case value_type::int_t:    { const std::int32_t v = static_cast<int>( value );   append( column_type::int32,   &v ); break; }
+        case value_type::size_t_t: { const std::uint64_t v = static_cast<size_t>( value ); append( column_type::uint64, &v ); break; }
+        case value_type::float_t:  { const float v = static_cast<float>( value );        append( column_type::float32, &v ); break; }
+        case value_type::double_t: { const double v = static_cast<double>( value );      append( column_type::float64, &v ); break; }
+        case value_type::string_t: append_string( value.native<std::string>() ); break;
+        default:                   throw std::runtime_error( "tuning parameter value has no column type" );
+      }
+    }
+
+    void append_string( const std::string& value )
+    {
+      auto& col = next_column( column_type::string );
+      auto  entry = col.codes.find( value );
+      if( entry == col.codes.end() )
+      {
+        entry = col.codes.emplace( value, static_cast<std::uint32_t>( col.codes.size() ) ).first;
+        col.new_entries.push_back( value );
+      }
+      append_bytes( col, &entry->second );
+    }
+
+    // completes the row; full chunks are handed over to the log writer
+    void end_row()
+    {
+      if( _next_column != _columns.size() )
+        throw std::runtime_error( "row of a tuning log is incomplete" );
+      _next_column = 0;
+      if( ++_num_rows == _chunk_rows )
+        write_chunk();
+    }
+
+  private:
+    struct column
+    {
+      std::string                                       name;
+      column_type                                       type;
+      std::vector<char>                                 values;      // of the current chunk
+      std::unordered_map<std::string, std::uint32_t>    codes;       // dictionary of string columns
+      std::vector<std::string>                          new_entries; // dictionary entries that first occur in the current chunk
+    };
+
+    size_t                        _chunk_rows;
+    std::unique_ptr<log_writer>   _out;
+    std::vector<column>           _columns;
+    size_t                        _num_rows;    // in the current chunk
+    size_t                        _next_column;
+    bool                          _schema_written;
+    std::string                   _chunk;       // serialized chunk, reused
+
+    column& next_column( column_type type )
+    {
+      if( _next_column >= _columns.size() || _columns[ _next_column ].type != type )
+        throw std::runtime_error( "value does not match the type of its column in the tuning log" );
+      return _columns[ _next_column++ ];
+    }
+
+    void append( column_type type, const void* value )
+    {
+      append_bytes( next_column( type ), value );
+    }
+
+    static void append_bytes( column& col, const void* value )
+    {
+      const char* bytes = static_cast<const char*>( value );
+      col.values.insert( col.values.end(), bytes, bytes + column_width( col.type ) );
+    }
+
+    void put_bytes( const void* data, size_t size )
+    {
+      write_bytes( _chunk, data, size );
+    }
+
+    void put_uint64( std::uint64_t value )
+    {
+      write_uint64( _chunk, value );
+    }
+
+    void put_string( const std::string& str )
+    {
+      write_string( _chunk, str );
+    }
+
+    void write_chunk()
+    {
+      _chunk.clear();
+      if( !_schema_written )
+      {
+        put_string( columnar_log_magic() );
+        put_uint64( _columns.size() );
+        for( const auto& col : _columns )
+        {
+          put_string( col.name );
+          put_uint64( static_cast<std::uint64_t>( col.type ) );
+        }
+        _schema_written = true;
+      }
+
+      if( _num_rows > 0 )
+      {
+        put_uint64( columnar_log_chunk_marker() );
+        put_uint64( _num_rows );
+        for( auto& col : _columns )
+        {
+          if( col.type == column_type::string )
+          {
+            put_uint64( col.new_entries.size() );
+            for( const auto& entry : col.new_entries )
+              put_string( entry );
+            col.new_entries.clear();
+          }
+          put_bytes( col.values.data(), col.values.size() );
+          col.values.clear();
+        }
+        put_uint64( columnar_log_chunk_marker() );
+        _num_rows = 0;
+      }
+
+      _out->write( _chunk.data(), _chunk.size() );
+      _out->flush();
+    }
+};
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* columnar_log_h */
@@ -0,0 +1,91 @@
+#ifndef cost_function_stages_h
+#define cost_function_stages_h
+
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "utility.hpp"
+#include "../flat_configuration.hpp"
+#include "../tuning_status.hpp"
+
+namespace atf
+{
+
+namespace detail
+{
+
+// true if the cost function has separate compile and measure stages: "compile( config )" prepares the program of a
+// configuration (e.g., builds its kernel) and returns it, "measure( compiled )" runs the prepared program and returns its cost
+template< typename callable >
+using compiled_program_t = std::decay_t<decltype( std::declval<callable&>().compile( std::declval<configuration&>() ) )>;
+
+template< typename callable, typename = void >
+struct has_compile_stage : std::false_type {};
+
+template< typename callable >
+struct has_compile_stage< callable, void_t<decltype( std::declval<callable&>().measure( std::declval<compiled_program_t<callable>&>() ) )> > : std::true_type {};
+
+
+// Compile and measure stages of a cost function for the configurations in "slots": the compiled program of a slot is kept
+// until it is measured. Cost functions without a compile stage are called as a whole in the measure stage.
+template< typename callable, bool = has_compile_stage<callable>::value >
+class cost_function_stages
+{
+  public:
+    explicit cost_function_stages( callable& cf )
+      : _cf( cf ), _compiled()
+    {}
+
+    void resize( size_t num_slots )
+    {
+      _compiled.resize( num_slots );
+    }
+
+    void compile( size_t slot, flat_configuration& config )
+    {
+      _compiled[ slot ].reset( new compiled_type( _cf.compile( config.as_configuration() ) ) );
+    }
+
+    cost_t measure( size_t slot, flat_configuration& )
+    {
+      auto compiled = std::move( _compiled[ slot ] );
+      return static_cast<cost_t>( _cf.measure( *compiled ) );
+    }
+
+  private:
+    using compiled_type = compiled_program_t<callable>;
+
+    callable&                                     _cf;
+    std::vector< std::unique_ptr<compiled_type> > _compiled;
+};
+
+template< typename callable >
+class cost_function_stages< callable, false >
+{
+  public:
+    explicit cost_function_stages( callable& cf )
+      : _cf( cf )
+    {}
+
+    void resize( size_t )
+    {}
+
+    void compile( size_t, flat_configuration& )
+    {}
+
+    cost_t measure( size_t, flat_configuration& config )
+    {
+      return call_cost_function( _cf, config, config.as_configuration(), 0 );
+    }
+
+  private:
+    callable& _cf;
+};
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* cost_function_stages_h */
@@ -0,0 +1,109 @@
+#ifndef evaluation_cache_h
+#define evaluation_cache_h
+
+#include <map>
+#include <list>
+
+#include "../big_int.hpp"
+#include "../tuning_status.hpp"
+#include "../pareto_archive.hpp"
+
+namespace atf
+{
+
+namespace detail
+{
+
+// Results of evaluated configurations by the configurations' canonical indices in the search space, such that configurations
+// requested again (e.g., different coordinates selecting the same configuration) are not evaluated again. The cache is either
+// unbounded, or holds at most "capacity" results and evicts the least recently used one.
+class evaluation_cache
+{
+  public:
+    struct result
+    {
+      cost_t cost;
+      bool   failed;
+      bool   replayed; // restored from a tuning database and not requested since
+      objective_vector objectives; // empty: unknown or no objectives
+    };
+
+    evaluation_cache()
+      : _enabled( false ), _capacity( 0 ), _results(), _lru()
+    {}
+
+    evaluation_cache( const evaluation_cache& other )
+      : _enabled( other._enabled ), _capacity( other._capacity ), _results(), _lru()
+    {}
+
+
+    // capacity "0": unbounded
+    void configure( bool enabled, size_t capacity )
+    {
+      _enabled  = enabled;
+      _capacity = capacity;
+      clear();
+    }
+
+
+    bool enabled() const
+    {
+      return _enabled;
+    }
+
+
+    void clear()
+    {
+      _results.clear();
+      _lru.clear();
+    }
+
+
+    // returns false if the index's result is not cached
+    bool find( const big_int& index, result& cached )
+    {
+      auto it = _results.find( index );
+      if( it == _results.end() )
+        return false;
+
+      if( _capacity > 0 )
+        _lru.splice( _lru.begin(), _lru, it->second.lru_position );
+      cached = it->second.value;
+      it->second.value.replayed = false;
+      return true;
+    }
+
+
+    void insert( const big_int& index, const result& value )
+    {
+      auto inserted = _results.emplace( index, entry{ value, _lru.end() } );
+      if( !inserted.second || _capacity == 0 )
+        return;
+
+      _lru.push_front( index );
+      inserted.first->second.lru_position = _lru.begin();
+      if( _results.size() > _capacity )
+      {
+        _results.erase( _lru.back() );
+        _lru.pop_back();
+      }
+    }
+
+  private:
+    struct entry
+    {
+      result                          value;
+      std::list< big_int >::iterator  lru_position; // bounded caches only
+    };
+
+    bool                        _enabled;
+    size_t                      _capacity;
+    std::map< big_int, entry >  _results;
+    std::list< big_int >        _lru; // most recently used first
+};
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* evaluation_cache_h */
@@ -22,7 +22,16 @@ auto G_class<TPs...>::tps() const
 template< typename... Ts, typename... range_ts, typename... callables >
 exploration_engine& exploration_engine::operator()(tp_t<Ts,range_ts,callables>&... tps )
 {
-  return this->operator()( G(tps...) );
+  // search space files are keyed by the TPs' grouping via "G(...)"; without splitting, the TPs form one group as well
+  if( !_search_space_file.empty() || !_split_independent_tps )
+    return this->operator()( G(tps...) );
+
+  // TPs are generated as separate trees if their predicates do not depend on each other
+  auto groups = independent_tp_groups( tps... );
+  if( groups.size() == 1 )
+    return this->operator()( G(tps...) );
+
+  return generate_tp_groups( groups, tps... );
 }
 
 // first application of operator(): IS (required due to ambiguity)
@@ -38,20 +47,109 @@ template< typename... Ts, typename... G_CLASSES >
 exploration_engine& exploration_engine::operator()(G_class<Ts...> G_class, G_CLASSES... G_classes )
 {
   const size_t num_trees = sizeof...(G_CLASSES) + 1;
+
+#ifdef LAZY_SEARCH_SPACE
+  // the trees' nodes are generated on demand when configurations are requested
+  if( !_search_space_file.empty() )
+    throw std::runtime_error( "search space files are not supported by LAZY_SEARCH_SPACE" );
+
+  const size_t first_tree_id = _search_space.num_trees();
+  _search_space.append_new_trees( num_trees );
+  insert_tp_names_in_search_space( G_class, G_classes... );
+  add_tps_to_lazy_trees( first_tree_id, G_class, G_classes... );
+#else
+#if defined(FLAT_SEARCH_SPACE) && !defined(COMPRESSED_SEARCH_SPACE)
+  // reuse the search space generated for the same TPs in a previous run
+  std::uint64_t key = 0;
+  if( !_search_space_file.empty() && _search_space.num_trees() == 0 )
+  {
+    key = search_space_key( G_class, G_classes... );
+    if( _search_space.load( _search_space_file, key ) )
+    {
+      std::vector<void*> tp_value_ptrs;
+      auto collect_tp_value_ptr = [&]( auto& tp ){
+        tp._act_elem->set_position( tp_value_ptrs.size() );
+        tp_value_ptrs.emplace_back( tp._act_elem->value_ptr() );
+      };
+      for_each_tp( collect_tp_value_ptr, G_class, G_classes... );
+      _search_space.set_tp_value_ptrs( tp_value_ptrs );
+      return *this;
+    }
+  }
+#else
+  if( !_search_space_file.empty() )
+    throw std::runtime_error( "search space files require FLAT_SEARCH_SPACE" );
+#endif
+
   _search_space.append_new_trees( num_trees );
   
   insert_tp_names_in_search_space( G_class, G_classes... );
   
-  return generate_config_trees<num_trees>( G_class, G_classes... );
+  generate_config_trees<num_trees>( G_class, G_classes... );
+#ifdef COMPRESSED_SEARCH_SPACE
+  _search_space.compress();
+#endif
+  _search_space.update_index_strides();
+
+#if defined(FLAT_SEARCH_SPACE) && !defined(COMPRESSED_SEARCH_SPACE)
+  if( !_search_space_file.empty() && _search_space.num_trees() == num_trees )
+    _search_space.save( _search_space_file, key );
+#endif
+#endif
+
+  return *this;
 }
 
 
 template< typename callable >
 tuning_status exploration_engine::operator()(callable& program ) // func must take config_t and return a value for which "<" is defined.
+{
+  return tune( program, detail::returns_objectives<callable>{} );
+}
+
+
+template< typename callable >
+tuning_status exploration_engine::tune( callable& program, std::true_type )
+{
+  if( _objective_names.empty() )
+    throw std::runtime_error( "cost function returns objective vectors, but the tuner has no objectives" );
+
+  detail::scalarized_cost_function<callable> scalarized_program( program, _objective_names.size(), _scalarization );
+  return tune( scalarized_program );
+}
+
+
+template< typename callable >
+tuning_status exploration_engine::tune( callable& program, std::false_type )
+{
+  if( !_objective_names.empty() )
+    throw std::runtime_error( "the tuner has objectives, but the cost function returns a single cost" );
+
+  return tune( program );
+}
+
+
+template< typename callable >
+tuning_status exploration_engine::tune( callable& program )
 {
   if (!_silent)
+#ifdef LAZY_SEARCH_SPACE
+    std::cout << "\nsearch space size: at most " << _search_space.num_configs() << std::endl << std::endl;
+#else
     std::cout << "\nsearch space size: " << _search_space.num_configs() << std::endl << std::endl;
+#endif
   
+  if( _pipelined && _num_evaluation_threads > 1 )
+    throw std::runtime_error( "pipelined evaluation measures one configuration at a time and requires a single evaluation thread" );
+
+#ifdef LAZY_SEARCH_SPACE
+  // the number of configurations is unknown, so the whole search space cannot be iterated over
+  if( _abort_condition == NULL )
+    throw std::runtime_error( "LAZY_SEARCH_SPACE requires an abort condition" );
+  if( _search_technique == NULL && _search_technique_1d == NULL )
+    throw std::runtime_error( "LAZY_SEARCH_SPACE requires a search technique other than exhaustive search" );
+#endif
+
   // if no abort condition is specified then iterate over the whole search space.
   if( _abort_condition == NULL )
     _abort_condition = std::unique_ptr<abort_condition>(new cond::evaluations(static_cast<size_t>( _search_space.num_configs() ) ) );
@@ -62,61 +160,578 @@ tuning_status exploration_engine::operator()(callable& program ) // func must ta
  
   // open file for verbose logging
   if (_log_file.empty())
-    _log_file = "tuning_log_" + atf::timestamp_str() + ".csv";
-  std::ofstream csv_file;
+    _log_file = "tuning_log_" + atf::timestamp_str() + (_log_format == log_format::binary ? ".atflog" : ".csv");
+  detail::log_writer csv_file(_log_buffer_capacity, _log_flush_interval);
   bool write_header = true;
-  csv_file.open(_log_file, std::ofstream::out | std::ofstream::trunc);
+  if (_log_format == log_format::binary)
+    _columnar_log.open(_log_file, _log_buffer_capacity, _log_flush_interval);
+  else
+    csv_file.open(_log_file);
   csv_file.precision(std::numeric_limits<cost_t>::max_digits10);
  
   auto start = std::chrono::steady_clock::now();
 
+  if( !_trace_file.empty() )
+  {
+    detail::tracer::instance().clear();
+    detail::tracer::instance().name_thread( "tuning" );
+    detail::tracer::instance().start();
+  }
+
+  _result_cache.clear();
+
+  // restore the evaluations of a resumed run before the search technique is initialized
+  std::string technique_state;
+  if( !_database_path.empty() )
+  {
+    if( _resume && !_result_cache.enabled() )
+      _result_cache.configure( true, 0 );
+    const size_t num_checkpointed_records = _resume ? read_checkpoint( technique_state ) : 0;
+    restore_records( _database.open( _database_path, search_space_id(), _resume ), num_checkpointed_records );
+  }
+
   initialize();
+
+  // continue the search technique's trajectory from its checkpoint
+  if( !technique_state.empty() )
+  {
+    std::istringstream state( technique_state );
+    if( _search_technique )
+      _search_technique->load_state( state );
+    else
+      _search_technique_1d->load_state( state );
+  }
+  _evaluations_at_checkpoint = _status._number_of_evaluated_configs;
+
+  // search techniques that do not support checkpoints throw here, instead of when the first checkpoint is due
+  if( !_checkpoint_path.empty() )
+  {
+    std::ostringstream state;
+    save_technique_state( state );
+  }
+  
+  if( _pipelined )
+    evaluate_pipelined( program, csv_file, write_header );
+  else if( _num_evaluation_threads > 1 )
+    evaluate_in_parallel( program, csv_file, write_header );
+  else
+    evaluate_sequentially( program, csv_file, write_header );
   
+  save_checkpoint_if_due( true );
+
+  finalize();
+  
+  csv_file.close();
+  _columnar_log.close();
+  _database.close();
+
+  if( !_trace_file.empty() )
+  {
+    detail::tracer::instance().stop();
+    write_chrome_trace( _trace_file );
+  }
+
+  if (!_silent)
+    std::cout << "\nnumber of evaluated configs: " << _status._number_of_evaluated_configs << " , number of valid configs: " << _status.number_of_valid_configs() << " , number of invalid configs: " << _status._number_of_invalid_configs << " , evaluations required to find best found result: " << _status._evaluations_required_to_find_best_found_result << " , valid evaluations required to find best found result: " << _status._valid_evaluations_required_to_find_best_found_result << std::endl;
+  if (!_silent && _status._number_of_timeouts > 0)
+    std::cout << "number of timeouts: " << _status._number_of_timeouts << std::endl;
+  if (!_silent && !_objective_names.empty())
+    std::cout << "size of Pareto front: " << _status._pareto_front.size() << std::endl;
+  if (!_silent && _result_cache.enabled())
+    std::cout << "number of cache hits: " << _status._number_of_cache_hits << " , cache hit rate: " << _status.cache_hit_rate() << std::endl;
+
+  auto end = std::chrono::steady_clock::now();
+  auto runtime_in_sec = std::chrono::duration_cast<std::chrono::seconds>( end - start ).count();
+  if (!_silent)
+    std::cout << std::endl << "total runtime for tuning = " << runtime_in_sec << "sec" << std::endl;
+  
+  
+  // output
+  if (!_silent)
+    std::cout << "tuning finished" << std::endl;
+  return _status;
+}
+
+
+template< typename callable >
+void exploration_engine::evaluate_sequentially( callable& program, detail::log_writer& csv_file, bool& write_header )
+{
   cost_t program_runtime = std::numeric_limits<cost_t>::max();
-  size_t get_next_config_ms, cost_function_ms, report_cost_ms;
+  size_t get_next_config_ms, cost_function_ms;
   while( !_abort_condition->stop( _status ) )
   {
     auto get_next_config_start = std::chrono::steady_clock::now();
-    auto config = get_next_config();
+    auto& flat_config = get_next_config();
+    auto& config      = flat_config.as_configuration();
     auto get_next_config_end = std::chrono::steady_clock::now();
     get_next_config_ms = std::chrono::duration_cast<std::chrono::milliseconds>(get_next_config_end - get_next_config_start).count();
 
+    big_int                               cache_key;
+    detail::evaluation_cache::result      cached_result;
+    if( needs_canonical_index() )
+      cache_key = next_canonical_index();
+    const bool is_cached = _result_cache.enabled() && _result_cache.find( cache_key, cached_result );
+
+    // evaluation restored from the tuning database: only the search technique has yet to see it
+    if( is_cached && cached_result.replayed )
+    {
+      report_result( cached_result.cost, cached_result.objectives );
+      save_checkpoint_if_due();
+      continue;
+    }
+
+    bool   failed        = false;
+    bool   timed_out     = false;
+    double cost_variance = std::numeric_limits<double>::quiet_NaN();
+    objective_vector objectives;
     ++_status._number_of_evaluated_configs;
     auto cost_function_start = std::chrono::steady_clock::now();
-    try
+    if( is_cached )
     {
-      program_runtime = program( config );
+      ++_status._number_of_cache_hits;
+      if( cached_result.failed )
+        ++_status._number_of_invalid_configs;
+      failed          = cached_result.failed;
+      program_runtime = cached_result.cost;
+      objectives      = cached_result.objectives;
     }
-    catch( ... )
+    else
     {
-      ++_status._number_of_invalid_configs;
-      
-      if( _abort_on_error )
-        abort();
-      else
-        program_runtime = std::numeric_limits<cost_t>::max();
+      detail::measurement_log() = &cost_variance;
+      detail::objective_log()   = &objectives;
+      try
+      {
+        trace_span span( "cost function", "engine" );
+        program_runtime = detail::call_cost_function( program, flat_config, config, 0 );
+      }
+      catch( ... )
+      {
+        detail::measurement_log() = nullptr;
+        detail::objective_log()   = nullptr;
+        ++_status._number_of_invalid_configs;
+        failed = true;
+        if( ( timed_out = is_timeout( std::current_exception() ) ) )
+          ++_status._number_of_timeouts;
+
+        if( _abort_on_error )
+          abort();
+        else
+          program_runtime = std::numeric_limits<cost_t>::max();
+      }
+      detail::measurement_log() = nullptr;
+      detail::objective_log()   = nullptr;
+
+      if( _result_cache.enabled() )
+        _result_cache.insert( cache_key, { program_runtime, failed, false, objectives } );
     }
     auto cost_function_end = std::chrono::steady_clock::now();
     cost_function_ms = std::chrono::duration_cast<std::chrono::milliseconds>(cost_function_end - cost_function_start).count();
     
-    auto current_best_result = std::get<2>( _status._history.back() );
-    if( program_runtime < current_best_result  )
+    append_to_database( cache_key, program_runtime, failed, timed_out, is_cached, objectives );
+    record_result( config, program_runtime, cost_variance, objectives, get_next_config_ms, cost_function_ms, csv_file, write_header );
+    save_checkpoint_if_due();
+  }
+}
+
+
+// The configurations requested by the search technique in one call are evaluated concurrently on the workers; afterwards,
+// their results are recorded in the order of the request, as in sequential evaluation, such that the technique's costs are
+// reported in a single "report_costs" call. All results of the request are recorded, also if the abort condition is met before
+// the last one: the evaluations have been paid for, and their results belong into the log and the tuning database.
+template< typename callable >
+void exploration_engine::evaluate_in_parallel( callable& program, detail::log_writer& csv_file, bool& write_header )
+{
+  detail::worker_pool workers( _num_evaluation_threads );
+
+  request_results request;
+  std::function<void( size_t )> evaluate = [ & ]( size_t k ) {
+    const size_t i = request.to_evaluate[ k ];
+    auto& config = request.configs[ i ];
+    auto cost_function_start = std::chrono::steady_clock::now();
+    detail::measurement_log() = &request.cost_variances[ i ];
+    detail::objective_log()   = &request.objectives[ i ];
+    try
     {
+      trace_span span( "cost function", "engine" );
+      request.costs[ i ]  = detail::call_cost_function( program, config, config.as_configuration(), 0 );
+      request.failed[ i ] = false;
+    }
+    catch( ... )
+    {
+      request.costs[ i ]  = std::numeric_limits<cost_t>::max();
+      request.failed[ i ] = is_timeout( std::current_exception() ) ? request_results::timed_out : 1;
+    }
+    detail::measurement_log() = nullptr;
+    detail::objective_log()   = nullptr;
+    auto cost_function_end = std::chrono::steady_clock::now();
+    request.cost_function_ms[ i ] = std::chrono::duration_cast<std::chrono::milliseconds>(cost_function_end - cost_function_start).count();
+  };
+
+  while( !_abort_condition->stop( _status ) )
+  {
+    // decode the requested configurations (a buffer per configuration)
+    const size_t num_configs = get_next_configs( request );
+
+    workers.run( request.to_evaluate.size(), evaluate );
+
+    for( size_t i = 0 ; i < num_configs ; ++i )
+      record_request_result( request, i, csv_file, write_header );
+
+    save_checkpoint_if_due();
+  }
+}
+
+
+// The configurations requested by the search technique in one call pass through a pipeline of stages connected by bounded
+// queues: this thread decodes them, a compile thread prepares their programs, and a measure thread measures them one at
+// a time; meanwhile, this thread records the measured results in the order of the request. The technique's next request
+// depends on the reported costs, such that stages overlap within a request only; hence, the technique is asked for requests
+// that fill the pipeline (see "batch_size").
+template< typename callable >
+void exploration_engine::evaluate_pipelined( callable& program, detail::log_writer& csv_file, bool& write_header )
+{
+  detail::cost_function_stages<callable> stages( program );
+
+  request_results request;
+
+  // stages exchange the configurations' positions in the request
+  detail::bounded_queue<size_t> to_compile( _pipeline_queue_capacity );
+  detail::bounded_queue<size_t> to_measure( _pipeline_queue_capacity );
+  detail::bounded_queue<size_t> measured( std::numeric_limits<size_t>::max() ); // the measure stage never waits for recording
+
+  std::thread compile_stage( [ & ]() {
+    detail::tracer::instance().name_thread( "compile stage" );
+    size_t i;
+    while( to_compile.pop( i ) )
+    {
+      auto compile_start = std::chrono::steady_clock::now();
+      try
+      {
+        trace_span span( "compile", "engine" );
+        stages.compile( i, request.configs[ i ] );
+        request.failed[ i ] = false;
+      }
+      catch( ... )
+      {
+        request.failed[ i ] = is_timeout( std::current_exception() ) ? request_results::timed_out : 1;
+      }
+      auto compile_end = std::chrono::steady_clock::now();
+      request.cost_function_ms[ i ] = std::chrono::duration_cast<std::chrono::milliseconds>(compile_end - compile_start).count();
+      to_measure.push( i );
+    }
+    to_measure.close();
+  } );
+
+  std::thread measure_stage( [ & ]() {
+    detail::tracer::instance().name_thread( "measure stage" );
+    size_t i;
+    while( to_measure.pop( i ) )
+    {
+      auto measure_start = std::chrono::steady_clock::now();
+      request.costs[ i ] = std::numeric_limits<cost_t>::max();
+      if( !request.failed[ i ] )
+      {
+        detail::measurement_log() = &request.cost_variances[ i ];
+        detail::objective_log()   = &request.objectives[ i ];
+        try
+        {
+          trace_span span( "measure", "engine" );
+          request.costs[ i ] = stages.measure( i, request.configs[ i ] );
+        }
+        catch( ... )
+        {
+          request.failed[ i ] = is_timeout( std::current_exception() ) ? request_results::timed_out : 1;
+        }
+        detail::measurement_log() = nullptr;
+        detail::objective_log()   = nullptr;
+      }
+      auto measure_end = std::chrono::steady_clock::now();
+      request.cost_function_ms[ i ] += std::chrono::duration_cast<std::chrono::milliseconds>(measure_end - measure_start).count();
+      measured.push( i );
+    }
+  } );
+
+  // the stages finish the configurations they have received; also if the technique, the database, or a checkpoint throws, since
+  // destroying the stages' threads before they are joined terminates the process
+  auto stop_stages = [ & ]() {
+    to_compile.close();
+    compile_stage.join();
+    measure_stage.join();
+  };
+
+  try
+  {
+    while( !_abort_condition->stop( _status ) )
+    {
+      // stages are idle between requests, such that the buffers can be resized
+      const size_t num_configs = get_next_configs( request );
+      stages.resize( num_configs );
+
+      for( size_t i : request.to_evaluate )
+        to_compile.push( i );
+
+      // results arrive in the order of the request; all of them are recorded, also if the abort condition is met before the last one
+      for( size_t i = 0 ; i < num_configs ; ++i )
+      {
+        size_t measured_i = i;
+        if( request.reused[ i ] == i )
+          measured.pop( measured_i );
+        assert( measured_i == i );
+
+        record_request_result( request, i, csv_file, write_header );
+      }
+
+      save_checkpoint_if_due();
+    }
+  }
+  catch( ... )
+  {
+    stop_stages();
+    throw;
+  }
+
+  stop_stages();
+}
+
+
+// counts the evaluation of configuration "i" of a request (taking its result from the cache or from a configuration of the request
+// with the same index, if reused), caches its result, and records it
+inline void exploration_engine::record_request_result( request_results& request, size_t i, detail::log_writer& csv_file, bool& write_header )
+{
+  // evaluation restored from the tuning database: only the search technique has yet to see it
+  if( request.replayed[ i ] )
+  {
+    report_result( request.costs[ i ], request.objectives[ i ] );
+    return;
+  }
+
+  ++_status._number_of_evaluated_configs;
+
+  const size_t reused = request.reused[ i ];
+  if( reused != i )
+  {
+    ++_status._number_of_cache_hits;
+    if( reused != request_results::cached )
+    {
+      request.costs[ i ]          = request.costs[ reused ];
+      request.cost_variances[ i ] = request.cost_variances[ reused ];
+      request.objectives[ i ]     = request.objectives[ reused ];
+      request.failed[ i ]         = request.failed[ reused ];
+    }
+    request.cost_function_ms[ i ] = 0;
+  }
+  else if( _result_cache.enabled() )
+    _result_cache.insert( request.cache_keys[ i ], { request.costs[ i ], request.failed[ i ] != 0, false, request.objectives[ i ] } );
+
+  if( request.failed[ i ] )
+  {
+    ++_status._number_of_invalid_configs;
+    if( request.failed[ i ] == request_results::timed_out && reused == i )
+      ++_status._number_of_timeouts;
+
+    if( _abort_on_error && reused == i )
+      abort();
+  }
+
+  if( _database.is_open() )
+    append_to_database( request.cache_keys[ i ], request.costs[ i ], request.failed[ i ] != 0, request.failed[ i ] == request_results::timed_out && reused == i, reused != i, request.objectives[ i ] );
+  record_result( request.configs[ i ].as_configuration(), request.costs[ i ], request.cost_variances[ i ], request.objectives[ i ], request.get_next_config_ms[ i ], request.cost_function_ms[ i ], csv_file, write_header );
+}
+
+
+// Restores the tuning status of a resumed run from the records of its tuning database. The records' results are put into the
+// result cache marked as "replayed": when the search technique requests such a configuration for the first time, its cost is
+// reported to the technique without counting or logging the evaluation again, such that the technique catches up to where the
+// run stopped. The first "num_checkpointed_records" records have been seen by the technique's checkpointed state already.
+inline void exploration_engine::restore_records( const std::vector< detail::tuning_record >& records, size_t num_checkpointed_records )
+{
+  if( records.size() < num_checkpointed_records )
+    throw std::runtime_error( "checkpoint is newer than the tuning database: " + _checkpoint_path );
+
+  const auto steady_now = std::chrono::steady_clock::now();
+  const auto system_now = std::chrono::system_clock::now();
+
+  for( const auto& record : records )
+  {
+    if( !( record.index < _search_space.num_configs() ) )
+      throw std::runtime_error( "tuning database contains a configuration outside of the search space" );
+    if( !record.objectives.empty() && record.objectives.size() != _objective_names.size() )
+      throw std::runtime_error( "tuning database was recorded for other objectives" );
+
+    ++_status._number_of_evaluated_configs;
+    if( record.failed )
+      ++_status._number_of_invalid_configs;
+    if( record.timed_out )
+      ++_status._number_of_timeouts;
+    if( record.cache_hit )
+      ++_status._number_of_cache_hits;
+
+    _result_cache.insert( record.index, { record.cost, record.failed, _status._number_of_evaluated_configs > num_checkpointed_records, record.objectives } );
+    if( !record.objectives.empty() )
+      _status._pareto_front.insert( record.objectives, _search_space.get_configuration( record.index ) );
+
+    if( record.cost < std::get<2>( _status._history.back() ) )
+    {
+      // the evaluation's time point relative to now
+      const auto recorded = std::chrono::system_clock::time_point( std::chrono::duration_cast<std::chrono::system_clock::duration>( std::chrono::nanoseconds( record.timestamp_ns ) ) );
       _status._evaluations_required_to_find_best_found_result = _status._number_of_evaluated_configs;
       _status._valid_evaluations_required_to_find_best_found_result = _status.number_of_valid_configs();
-      _status._history.emplace_back( std::chrono::steady_clock::now(),
-                             config,
-                             program_runtime
-                           );
+      _status._history.emplace_back( steady_now - std::chrono::duration_cast<std::chrono::steady_clock::duration>( system_now - recorded ),
+                                     _search_space.get_configuration( record.index ),
+                                     record.cost
+                                   );
     }
+  }
+
+  if( !_silent && !records.empty() )
+    std::cout << "restored evaluations: " << records.size() << " , current best result: " << _status.min_cost() << std::endl << std::endl;
+}
+
+
+// A checkpoint holds the search technique's state and the number of evaluations it has seen; returns this number and the state
+// (empty if there is no checkpoint).
+inline size_t exploration_engine::read_checkpoint( std::string& technique_state )
+{
+  technique_state.clear();
+  if( _checkpoint_path.empty() )
+    return 0;
+
+  std::ifstream in( _checkpoint_path );
+  if( !in.good() )
+    return 0;
+
+  std::string   magic;
+  std::uint64_t id;
+  size_t        num_evaluations;
+  if( !std::getline( in, magic ) || magic != "ATF checkpoint v1" || !( in >> id >> num_evaluations ) )
+    throw std::runtime_error( "not a checkpoint: " + _checkpoint_path );
+  if( id != search_space_id() )
+    throw std::runtime_error( "checkpoint was saved for other tuning parameters: " + _checkpoint_path );
+
+  technique_state.assign( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+  return num_evaluations;
+}
+
+
+// Checkpoints are saved between requests of the search technique, once "_checkpoint_interval" evaluations have been recorded
+// since the last one ("force": at any number of evaluations). The state is written to a temporary file that replaces the
+// checkpoint, such that a crash while saving keeps the previous checkpoint.
+inline void exploration_engine::save_checkpoint_if_due( bool force )
+{
+  if( _checkpoint_path.empty() || !_next_coordinates.empty() || !_next_indices_1d.empty() )
+    return;
+  if( !force && _status._number_of_evaluated_configs < _evaluations_at_checkpoint + _checkpoint_interval )
+    return;
+
+  trace_span span( "save checkpoint", "engine" );
+  const std::string temporary_path = _checkpoint_path + ".tmp";
+  std::ofstream out( temporary_path, std::ios::trunc );
+  out << "ATF checkpoint v1" << std::endl << search_space_id() << " " << _status._number_of_evaluated_configs << std::endl;
+  save_technique_state( out );
+  out.close();
+  if( !out )
+    throw std::runtime_error( "cannot write checkpoint: " + temporary_path );
 
-    auto report_cost_start = std::chrono::steady_clock::now();
-    report_result( program_runtime );
-    auto report_cost_end = std::chrono::steady_clock::now();
-    report_cost_ms = std::chrono::duration_cast<std::chrono::milliseconds>(report_cost_end - report_cost_start).count();
+#if !defined(__unix__) && !defined(__APPLE__)
+  std::remove( _checkpoint_path.c_str() ); // "std::rename" does not replace existing files on all platforms
+#endif
+  if( std::rename( temporary_path.c_str(), _checkpoint_path.c_str() ) != 0 )
+    throw std::runtime_error( "cannot write checkpoint: " + _checkpoint_path );
 
+  _evaluations_at_checkpoint = _status._number_of_evaluated_configs;
+}
+
+
+inline void exploration_engine::save_technique_state( std::ostream& out ) const
+{
+  if( _search_technique )
+    _search_technique->save_state( out );
+  else
+    _search_technique_1d->save_state( out );
+}
+
+
+inline void exploration_engine::append_to_database( const big_int& canonical, cost_t cost, bool failed, bool timed_out, bool cache_hit, const objective_vector& objectives )
+{
+  if( !_database.is_open() )
+    return;
+
+  trace_span span( "append to database", "engine" );
+  const auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::system_clock::now().time_since_epoch() ).count();
+  _database.append( { canonical, cost, failed, timed_out, cache_hit, static_cast<std::int64_t>( timestamp ), objectives } );
+}
+
+
+inline bool exploration_engine::is_timeout( std::exception_ptr exception )
+{
+  try
+  {
+    std::rethrow_exception( exception );
+  }
+  catch( const evaluation_timeout& )
+  {
+    return true;
+  }
+  catch( ... )
+  {
+    return false;
+  }
+}
+
+
+// identifies the search space in tuning databases by the TPs' names, the number of configurations, and the values of
+// configurations sampled evenly from the search space
+inline std::uint64_t exploration_engine::search_space_id() const
+{
+  detail::fnv1a_hash hash;
+
+  for( const auto& name : _search_space.names() )
+    hash.add( name );
+
+  const big_int num_configs = _search_space.num_configs();
+  hash.add( static_cast<std::string>( num_configs ) );
+
+  const size_t num_samples = 64;
+  for( size_t i = 0 ; i < num_samples && big_int( i ) < num_configs ; ++i )
+    for( const auto& tp : _search_space.get_configuration( num_configs * big_int( i ) / big_int( num_samples ) ) )
+      hash.add( tp.second.value() );
+
+  return hash.value();
+}
+
+
+// updates the history and the Pareto front, reports the cost to the search technique, and logs the evaluation (with the variance
+// of its cost, if measured repeatedly; see "measurement", and its objectives, if any)
+inline void exploration_engine::record_result( const configuration& config, cost_t program_runtime, double cost_variance, const objective_vector& objectives, size_t get_next_config_ms, size_t cost_function_ms, detail::log_writer& csv_file, bool& write_header )
+{
+  auto current_best_result = std::get<2>( _status._history.back() );
+  if( program_runtime < current_best_result  )
+  {
+    _status._evaluations_required_to_find_best_found_result = _status._number_of_evaluated_configs;
+    _status._valid_evaluations_required_to_find_best_found_result = _status.number_of_valid_configs();
+    _status._history.emplace_back( std::chrono::steady_clock::now(),
+                           config,
+                           program_runtime
+                         );
+  }
+
+  if( !objectives.empty() )
+    _status._pareto_front.insert( objectives, config );
+
+  auto report_cost_start = std::chrono::steady_clock::now();
+  report_result( program_runtime, objectives );
+  auto report_cost_end = std::chrono::steady_clock::now();
+  size_t report_cost_ms = std::chrono::duration_cast<std::chrono::milliseconds>(report_cost_end - report_cost_start).count();
+
+  trace_span span( "log result", "engine" );
+  if (_columnar_log.is_open())
+    append_to_columnar_log(config, program_runtime, cost_variance, objectives, get_next_config_ms, cost_function_ms, report_cost_ms, write_header);
+  else {
     if (write_header) {
-      csv_file << "timestamp;cost";
+      csv_file << "timestamp;cost;cost_variance";
+      for (const auto &name : _objective_names) {
+        csv_file << ";" << name;
+      }
       for (const auto &tp : config) {
         csv_file << ";" << tp.first;
       }
@@ -125,36 +740,342 @@ tuning_status exploration_engine::operator()(callable& program ) // func must ta
 #endif
       write_header = false;
     }
-    csv_file << std::endl << atf::timestamp_str() << ";" << program_runtime;
+    csv_file << '\n';
+    csv_file.timestamp() << ";" << program_runtime << ";";
+    if (!std::isnan(cost_variance)) {
+      csv_file << cost_variance;
+    }
+    for (size_t i = 0; i < _objective_names.size(); ++i) {
+      csv_file << ";";
+      if (i < objectives.size()) {
+        csv_file << objectives[i];
+      }
+    }
     for (const auto &tp : config) {
       csv_file << ";" << tp.second.value();
     }
 #ifdef ATF_EXTENDED_LOG
     csv_file << ";" << get_next_config_ms << ";" << cost_function_ms << ";" << report_cost_ms;
 #endif
+    csv_file.flush(); // hands the row over to the log writer's thread
+  }
+
+  if (!_silent)
+    std::cout << std::endl << "evaluated configs: " << _status._number_of_evaluated_configs << " , valid configs: " << _status.number_of_valid_configs() << " , program cost: " << program_runtime << " , current best result: " << _status.min_cost() << std::endl << std::endl;
+}
 
-    if (!_silent)
-      std::cout << std::endl << "evaluated configs: " << _status._number_of_evaluated_configs << " , valid configs: " << _status.number_of_valid_configs() << " , program cost: " << program_runtime << " , current best result: " << _status.min_cost() << std::endl << std::endl;
 
+// columns: as in CSV logs, with typed TP columns (see "detail::columnar_log_writer")
+inline void exploration_engine::append_to_columnar_log( const configuration& config, cost_t program_runtime, double cost_variance, const objective_vector& objectives, size_t get_next_config_ms, size_t cost_function_ms, size_t report_cost_ms, bool& write_header )
+{
+  if( write_header )
+  {
+    _columnar_log.add_column( "timestamp", detail::column_type::timestamp );
+    _columnar_log.add_column( "cost", detail::column_type::float64 );
+    _columnar_log.add_column( "cost_variance", detail::column_type::float64 );
+    for( const auto& name : _objective_names )
+      _columnar_log.add_column( name, detail::column_type::float64 );
+    for( const auto& tp : config )
+      _columnar_log.add_column( tp.first, detail::column_type_of( tp.second.value().type_id() ) );
+#ifdef ATF_EXTENDED_LOG
+    _columnar_log.add_column( "get_next_config_ms", detail::column_type::uint64 );
+    _columnar_log.add_column( "cost_function_ms", detail::column_type::uint64 );
+    _columnar_log.add_column( "report_cost_ms", detail::column_type::uint64 );
+#endif
+    write_header = false;
   }
-  
-  finalize();
-  
-  csv_file.close();
 
-  if (!_silent)
-    std::cout << "\nnumber of evaluated configs: " << _status._number_of_evaluated_configs << " , number of valid configs: " << _status.number_of_valid_configs() << " , number of invalid configs: " << _status._number_of_invalid_configs << " , evaluations required to find best found result: " << _status._evaluations_required_to_find_best_found_result << " , valid evaluations required to find best found result: " << _status._valid_evaluations_required_to_find_best_found_result << std::endl;
+  _columnar_log.append_timestamp( std::chrono::system_clock::now() );
+  _columnar_log.append_float64( program_runtime );
+  _columnar_log.append_float64( cost_variance );
+  for( size_t i = 0 ; i < _objective_names.size() ; ++i )
+    _columnar_log.append_float64( i < objectives.size() ? objectives[ i ] : std::numeric_limits<double>::quiet_NaN() );
+  for( const auto& tp : config )
+    _columnar_log.append_value( tp.second.value() );
+#ifdef ATF_EXTENDED_LOG
+  _columnar_log.append_uint64( get_next_config_ms );
+  _columnar_log.append_uint64( cost_function_ms );
+  _columnar_log.append_uint64( report_cost_ms );
+#endif
+  _columnar_log.end_row();
+}
 
-  auto end = std::chrono::steady_clock::now();
-  auto runtime_in_sec = std::chrono::duration_cast<std::chrono::seconds>( end - start ).count();
-  if (!_silent)
-    std::cout << std::endl << "total runtime for tuning = " << runtime_in_sec << "sec" << std::endl;
-  
-  
-  // output
-  if (!_silent)
-    std::cout << "tuning finished" << std::endl;
-  return _status;
+
+// The TPs read by a predicate are the TPs among the parameters of its structured predicates (e.g., "A" in "divides( A )"); these are
+// known without evaluating the predicate. Other predicates (e.g., lambdas, which may read TPs without capturing them) are assumed to
+// read all preceding TPs.
+template< typename... Ts, typename... range_ts, typename... callables >
+std::vector< std::vector<size_t> > exploration_engine::independent_tp_groups( tp_t<Ts,range_ts,callables>&... tps )
+{
+  const size_t num_tps = sizeof...(Ts);
+
+  const std::vector< std::string >  names = { tps.name()... };
+  std::vector< detail::parameter_tp_names > reads( num_tps );
+  std::vector< bool >                       known( num_tps );
+  size_t tp_id = 0;
+  auto collect_reads = { 0, ( known[ tp_id ] = detail::has_known_parameters<callables>::value && detail::hash_parameters( reads[ tp_id ], tps._predicate ), ++tp_id, 0 )... };
+  static_cast<void>( collect_reads );
+
+  // union-find over the TPs
+  std::vector< size_t > representative( num_tps );
+  for( size_t i = 0 ; i < num_tps ; ++i )
+    representative[ i ] = i;
+  auto find = [&]( size_t i ){
+    while( representative[ i ] != i )
+      i = representative[ i ] = representative[ representative[ i ] ];
+    return i;
+  };
+
+  for( size_t i = 0 ; i < num_tps ; ++i )
+  {
+    if( !known[ i ] )
+    {
+      for( size_t j = 0 ; j < i ; ++j )
+        representative[ find( i ) ] = find( j );
+      continue;
+    }
+
+    for( const auto& read : reads[ i ].names )
+      for( size_t j = 0 ; j < num_tps ; ++j )
+        if( names[ j ] == read )
+          representative[ find( i ) ] = find( j );
+  }
+
+  // groups in order of their first TPs
+  std::vector< std::vector<size_t> > groups;
+  std::map< size_t, size_t >         group_of_representative;
+  for( size_t i = 0 ; i < num_tps ; ++i )
+  {
+    auto group = group_of_representative.emplace( find( i ), groups.size() );
+    if( group.second )
+      groups.emplace_back();
+    groups[ group.first->second ].emplace_back( i );
+  }
+
+  return groups;
+}
+
+
+template< typename... Ts, typename... range_ts, typename... callables >
+exploration_engine& exploration_engine::generate_tp_groups( const std::vector< std::vector<size_t> >& groups, tp_t<Ts,range_ts,callables>&... tps )
+{
+  const std::vector< std::string > names = { tps.name()... };
+
+  const size_t first_tree_id = _search_space.num_trees();
+  _search_space.append_new_trees( groups.size() );
+  std::vector< size_t > position_of_tp( sizeof...(Ts) );
+  for( const auto& group : groups )
+    for( const auto& i : group )
+    {
+      position_of_tp[ i ] = _search_space.names().size();
+      _search_space.add_name( names[ i ] );
+    }
+  size_t tp_id = 0;
+  auto set_positions = { 0, ( tps._act_elem->set_position( position_of_tp[ tp_id++ ] ), 0 )... };
+  static_cast<void>( set_positions );
+
+#ifdef LAZY_SEARCH_SPACE
+  std::vector< size_t > tree_of_tp( sizeof...(Ts) );
+  for( size_t group_id = 0 ; group_id < groups.size() ; ++group_id )
+    for( const auto& i : groups[ group_id ] )
+      tree_of_tp[ i ] = first_tree_id + group_id;
+
+  size_t i = 0;
+  auto add_tp = [&]( auto& tp ){ _search_space.tree( tree_of_tp[ i++ ] ).add_tp( tp, tp._act_elem->value_ptr() ); };
+  auto add_tps = { 0, ( add_tp( tps ), 0 )... };
+  static_cast<void>( add_tps );
+#else
+  const std::vector< group_tp > group_tps = { make_group_tp( tps )... };
+  for( size_t group_id = 0 ; group_id < groups.size() ; ++group_id )
+  {
+    std::vector< group_tp > tps_of_group;
+    for( const auto& i : groups[ group_id ] )
+      tps_of_group.emplace_back( group_tps[ i ] );
+
+    const size_t tree_id = first_tree_id + group_id;
+#ifdef PARALLEL_SEARCH_SPACE_GENERATION
+    start_generation_thread( [ this, tree_id, tps_of_group ]() mutable {
+#endif
+      generate_tree_of_tp_group< sizeof...(Ts) >( tree_id, tps_of_group );
+#ifdef PARALLEL_SEARCH_SPACE_GENERATION
+    } );
+#endif
+  }
+  generate_config_trees<0>();  // waits for the trees generated in parallel
+
+#ifdef COMPRESSED_SEARCH_SPACE
+  _search_space.compress();
+#endif
+  _search_space.update_index_strides();
+#endif
+
+  return *this;
+}
+
+
+#ifndef LAZY_SEARCH_SPACE
+template< typename T, typename range_t, typename callable >
+exploration_engine::group_tp exploration_engine::make_group_tp( tp_t<T,range_t,callable>& tp )
+{
+  auto act_elem = tp._act_elem;
+
+  // each copy iterates over its own copy of the TP's range
+  return { [ tp ]( value_type& value ) mutable {
+             T tp_value;
+             if( !tp.get_next_value( tp_value ) )
+               return false;
+             value = value_type( tp_value );
+             return true;
+           },
+           std::make_shared<group_tp::act_elem_t>( group_tp::act_elem_t{ act_elem->value_ptr(), [ act_elem ]( size_t num_workers ){ act_elem->set_num_workers( num_workers ); } } ) };
+}
+
+
+// the depth of a group's tree is known at runtime only: selects the instantiation of "generate_config_tree" for it
+template< size_t TREE_DEPTH, std::enable_if_t<( TREE_DEPTH>0 )>* >
+void exploration_engine::generate_tree_of_tp_group( size_t tree_id, std::vector<group_tp>& tps )
+{
+  if( tps.size() == TREE_DEPTH )
+    generate_tree_of_tp_group( tree_id, tps, std::make_index_sequence<TREE_DEPTH>{} );
+  else
+    generate_tree_of_tp_group< TREE_DEPTH-1 >( tree_id, tps );
+}
+
+
+template< size_t... Is >
+void exploration_engine::generate_tree_of_tp_group( size_t tree_id, std::vector<group_tp>& tps, std::index_sequence<Is...> )
+{
+  generate_config_tree< sizeof...(Is) >( tree_id, tps[ Is ]... );
+}
+#endif
+
+
+template< typename... Ts, typename... range_ts, typename... callables >
+search_space_size exploration_engine::count_configs( tp_t<Ts,range_ts,callables>&... tps )
+{
+  return count_configs( G(tps...) );
+}
+
+
+template< typename... Ts, typename... G_CLASSES >
+search_space_size exploration_engine::count_configs( G_class<Ts...> G_class, G_CLASSES... G_classes )
+{
+  search_space_size size{ 1, {} };
+  count_configs_of_groups( size, G_class, G_classes... );
+
+  return size;
+}
+
+
+template< typename... Ts, typename... rest_tp_tuples >
+void exploration_engine::count_configs_of_groups( search_space_size& size, G_class<Ts...> tp_tuple, rest_tp_tuples... tuples )
+{
+  count_configs_of_one_group( size, tp_tuple, std::make_index_sequence<sizeof...(Ts)>{} );
+  count_configs_of_groups( size, tuples... );
+}
+
+
+template< typename... Ts, size_t... Is >
+void exploration_engine::count_configs_of_one_group( search_space_size& size, G_class<Ts...> tp_tuple, std::index_sequence<Is...> )
+{
+  std::vector< size_t > num_nodes( sizeof...(Is), 0 );
+  size.num_configs = size.num_configs * count_configs_in_parallel( num_nodes, std::get<Is>( tp_tuple.tps() )... );
+  for( const auto& num_nodes_of_tp : num_nodes )
+    size.num_nodes.emplace_back( num_nodes_of_tp );
+}
+
+
+// each worker enumerates the values of the first TP on its own copies of the TPs, and counts the subtrees of the values it has claimed;
+// the subtrees' counts are summed up as "big_int", as the number of configurations of a group may exceed "size_t"
+template< typename T, typename range_t, typename callable, typename... Ts >
+big_int exploration_engine::count_configs_in_parallel( std::vector<size_t>& num_nodes, tp_t<T,range_t,callable>& tp, Ts&... tps )
+{
+#ifdef PARALLEL_SEARCH_SPACE_GENERATION_THREADS
+  const size_t num_workers = PARALLEL_SEARCH_SPACE_GENERATION_THREADS;
+#else
+  const size_t num_workers = std::max( std::thread::hardware_concurrency(), 1u );
+#endif
+
+  // provide a value slot per worker in each TP of the tree
+  tp._act_elem->set_num_workers( num_workers );
+  auto set_num_workers = { 0, ( tps._act_elem->set_num_workers( num_workers ), 0 )... };
+  static_cast<void>( set_num_workers );
+
+  std::atomic<size_t>                 next_value( 0 );
+  std::vector< std::vector<size_t> >  num_nodes_of_workers( num_workers, std::vector<size_t>( num_nodes.size(), 0 ) );
+  std::vector< big_int >              num_leafs_of_workers( num_workers, big_int( 0 ) );
+  std::vector< std::exception_ptr >   errors_of_workers( num_workers );
+  std::vector< std::thread >          workers;
+  for( size_t worker_id = 1 ; worker_id <= num_workers ; ++worker_id )
+  {
+    workers.emplace_back( [ &, worker_id, tp, tps... ]() mutable {
+      detail::generation_worker_id() = worker_id;
+      auto& worker_num_nodes = num_nodes_of_workers[ worker_id - 1 ];
+
+      size_t claimed_value = next_value++;
+      size_t value_id      = 0;
+      T value;
+      try
+      {
+        while( tp.get_next_value( value ) )
+        {
+          // skip values that are not claimed by this worker
+          if( value_id++ != claimed_value )
+            continue;
+          claimed_value = next_value++;
+
+          const size_t num_leafs = count_configs_of_subtrees( worker_num_nodes.data() + 1, tps... );
+          if( num_leafs > 0 )
+            ++worker_num_nodes[ 0 ];
+          num_leafs_of_workers[ worker_id - 1 ] = num_leafs_of_workers[ worker_id - 1 ] + big_int( num_leafs );
+        }
+      }
+      catch( ... )
+      {
+        errors_of_workers[ worker_id - 1 ] = std::current_exception();
+      }
+      detail::generation_worker_id() = 0;
+    } );
+  }
+
+  for( auto& worker : workers )
+    worker.join();
+
+  for( const auto& error : errors_of_workers )
+    if( error )
+      std::rethrow_exception( error );
+
+  big_int num_leafs = 0;
+  for( size_t worker_id = 0 ; worker_id < num_workers ; ++worker_id )
+  {
+    num_leafs = num_leafs + num_leafs_of_workers[ worker_id ];
+    for( size_t i = 0 ; i < num_nodes.size() ; ++i )
+      num_nodes[ i ] += num_nodes_of_workers[ worker_id ][ i ];
+  }
+
+  return num_leafs;
+}
+
+
+// returns the number of leafs below the current path; "num_nodes[ i ]" counts the nodes with leafs of the i-th TP below the path;
+// throws if the number of leafs below a value of the first TP of a group exceeds "size_t"
+template< typename T, typename range_t, typename callable, typename... Ts >
+size_t exploration_engine::count_configs_of_subtrees( size_t* num_nodes, tp_t<T,range_t,callable>& tp, Ts&... tps )
+{
+  size_t num_leafs = 0;
+
+  T value;
+  while( tp.get_next_value( value ) )
+  {
+    const size_t num_leafs_of_value = count_configs_of_subtrees( num_nodes + 1, tps... );
+    if( num_leafs_of_value > 0 )
+      ++num_nodes[ 0 ];
+    if( num_leafs_of_value > std::numeric_limits<size_t>::max() - num_leafs )
+      throw std::runtime_error( "number of configurations exceeds the range of size_t" );
+    num_leafs += num_leafs_of_value;
+  }
+
+  return num_leafs;
 }
 
 
@@ -175,12 +1096,79 @@ void exploration_engine::insert_tp_names_of_one_tree_in_search_space (G_class<Ts
 template< typename T, typename range_t, typename callable, typename... Ts >
 void exploration_engine::insert_tp_names_of_one_tree_in_search_space (tp_t<T,range_t,callable>& tp, Ts&... tps )
 {
+  tp._act_elem->set_position( _search_space.names().size() );
   _search_space.add_name( tp.name() );
   
   insert_tp_names_of_one_tree_in_search_space ( tps... );
 }
 
 
+template< typename callable, typename... Ts, typename... rest_tp_tuples >
+void exploration_engine::for_each_tp( callable& f, G_class<Ts...> tp_tuple, rest_tp_tuples... tuples )
+{
+  for_each_tp_of_one_tree( f, tp_tuple, std::make_index_sequence<sizeof...(Ts)>{} );
+
+  for_each_tp( f, tuples... );
+}
+
+
+template< typename callable, typename... Ts, size_t... Is >
+void exploration_engine::for_each_tp_of_one_tree( callable& f, G_class<Ts...> tp_tuple, std::index_sequence<Is...> )
+{
+  auto call_f = { ( f( std::get<Is>( tp_tuple.tps() ) ), 0 )... };
+  static_cast<void>( call_f );
+}
+
+
+#ifdef LAZY_SEARCH_SPACE
+template< typename... Ts, typename... rest_tp_tuples >
+void exploration_engine::add_tps_to_lazy_trees( size_t tree_id, G_class<Ts...> tp_tuple, rest_tp_tuples... tuples )
+{
+  auto add_tp = [&]( auto& tp ){ _search_space.tree( tree_id ).add_tp( tp, tp._act_elem->value_ptr() ); };
+  for_each_tp_of_one_tree( add_tp, tp_tuple, std::make_index_sequence<sizeof...(Ts)>{} );
+
+  add_tps_to_lazy_trees( tree_id + 1, tuples... );
+}
+#endif
+
+
+// Hashes the user's key, the TP groups, and per TP its name, its type (comprising the types of range and predicate), the values of
+// its range (a sample of at most 2^16 values for larger ranges), and the parameters of its predicate. Predicates with state that
+// cannot be hashed (e.g., lambdas with captures) require a user key.
+template< typename... G_CLASSES >
+std::uint64_t exploration_engine::search_space_key( G_CLASSES... G_classes )
+{
+  detail::fnv1a_hash hash;
+  hash.add( _search_space_key );
+
+  for( auto num_tps : { std::tuple_size<decltype( G_classes.tps() )>::value... } )
+    hash.add( static_cast<std::uint64_t>( num_tps ) );
+
+  auto hash_tp = [&]( auto& tp )
+  {
+    hash.add( tp.name() );
+    hash.add( std::string( typeid( tp ).name() ) );
+
+    const auto& range       = *tp.get_range_ptr();
+    const size_t size       = range.size();
+    const size_t max_sample = 1 << 16;
+    const size_t stride     = size <= max_sample ? 1 : ( size - 1 ) / ( max_sample - 1 );
+    hash.add( static_cast<std::uint64_t>( size ) );
+    for( size_t i = 0 ; i < size ; i += stride )
+      hash.add( range[ i ] );
+    if( size > 0 )
+      hash.add( range[ size - 1 ] );
+
+    if( !detail::hash_parameters( hash, tp._predicate ) && _search_space_key.empty() )
+      throw std::runtime_error( "search space file: the predicate of TP \"" + tp.name() + "\" has captures that cannot be checked; a key identifying them is required" );
+  };
+  for_each_tp( hash_tp, G_classes... );
+
+  return hash.value();
+}
+
+
+#ifndef LAZY_SEARCH_SPACE
 template< size_t TREE_ID, typename... Ts, typename... rest_tp_tuples>
 exploration_engine& exploration_engine::generate_config_trees(G_class<Ts...> tp_tuple, rest_tp_tuples... tuples )
 {
@@ -193,11 +1181,12 @@ exploration_engine& exploration_engine::generate_config_trees(G_class<Ts...> tp_
 {
   // fill generated config tree
   const size_t TREE_DEPTH = sizeof...(Is);
+  const size_t tree_id    = _search_space.num_trees() - TREE_ID;
 
 #ifdef PARALLEL_SEARCH_SPACE_GENERATION
-  _threads.emplace_back( [=](){
+  start_generation_thread( [=](){
 #endif
-    generate_single_config_tree< TREE_ID, TREE_DEPTH >( std::get<Is>( tp_tuple.tps() )... );
+    generate_config_tree< TREE_DEPTH >( tree_id, std::get<Is>( tp_tuple.tps() )... );
 #ifdef PARALLEL_SEARCH_SPACE_GENERATION
   } );
 #endif
@@ -214,28 +1203,168 @@ exploration_engine& exploration_engine::generate_config_trees()
     thread.join();
   
   _threads.clear();
+
+  std::exception_ptr error;
+  for( const auto& thread_error : _thread_errors )
+    if( thread_error && !error )
+      error = thread_error;
+  _thread_errors.clear();
+  if( error )
+    std::rethrow_exception( error );
 #endif
 
   return *this;
 }
 
 
-template< size_t TREE_ID, size_t TREE_DEPTH, typename T, typename range_t, typename callable, typename... Ts, std::enable_if_t<( TREE_DEPTH > 0 )>* >
-void exploration_engine::generate_single_config_tree(tp_t<T,range_t,callable>& tp, Ts&... tps )
+#ifdef PARALLEL_SEARCH_SPACE_GENERATION
+// generates a tree on a thread of its own; an exception (e.g., of a constraint) is passed on once the threads are joined
+template< typename callable >
+void exploration_engine::start_generation_thread( callable generate )
 {
-  T value;
+  _thread_errors.emplace_back();
+  auto& error = _thread_errors.back();
+  _threads.emplace_back( [ generate, &error ]() mutable {
+    try
+    {
+      generate();
+    }
+    catch( ... )
+    {
+      error = std::current_exception();
+    }
+  } );
+}
+#endif
+
+
+template< size_t TREE_DEPTH, typename... Ts >
+void exploration_engine::generate_config_tree( size_t tree_id, Ts&... tps )
+{
+#ifdef PARALLEL_SEARCH_SPACE_GENERATION_SPLIT_DEPTH
+  generate_single_config_tree_in_parallel< TREE_DEPTH >( tree_id, tps... );
+#else
+  generate_single_config_tree< TREE_DEPTH >( tree_id, tps... );
+#endif
+}
+
+
+template< size_t TREE_DEPTH, typename TP, typename... Ts, std::enable_if_t<( TREE_DEPTH > 0 )>* >
+void exploration_engine::generate_single_config_tree( size_t tree_id, TP& tp, Ts&... tps )
+{
+  typename TP::type value;
   while( tp.get_next_value(value) )
   {
-    auto value_tp_pair = std::make_pair( value, static_cast<void*>( tp._act_elem.get() /*&(tp._act_elem)*/ ) );
-    generate_single_config_tree< TREE_ID, TREE_DEPTH-1 >( tps..., value_tp_pair );
+    auto value_tp_pair = std::make_pair( value, static_cast<void*>( tp._act_elem->value_ptr() ) );
+    generate_single_config_tree< TREE_DEPTH-1 >( tree_id, tps..., value_tp_pair );
   }
 }
 
 
-template< size_t TREE_ID, size_t TREE_DEPTH, typename... Ts, std::enable_if_t<( TREE_DEPTH == 0 )>*  >
-void exploration_engine::generate_single_config_tree(const Ts&... values )
+template< size_t TREE_DEPTH, typename... Ts, std::enable_if_t<( TREE_DEPTH == 0 )>*  >
+void exploration_engine::generate_single_config_tree( size_t tree_id, const Ts&... values )
+{
+  _search_space.tree( tree_id ).insert( values... );   }
+
+
+#ifdef PARALLEL_SEARCH_SPACE_GENERATION_SPLIT_DEPTH
+// Splits the paths of the first PARALLEL_SEARCH_SPACE_GENERATION_SPLIT_DEPTH TPs (prefixes) among worker threads: each worker
+// enumerates the prefixes on its own copies of the TPs, generates the subtrees of the prefixes it has claimed, and the subtrees
+// are appended to the tree in prefix order afterwards, such that the tree (and its leaf order) equals the sequentially generated one.
+template< size_t TREE_DEPTH, typename... Ts >
+void exploration_engine::generate_single_config_tree_in_parallel( size_t tree_id, Ts&... tps )
 {
-  _search_space.tree( _search_space.num_trees() -  TREE_ID ).insert( values... );   }
+  // the subtrees' leafs must lie below the split level
+  const size_t split_depth = std::min( static_cast<size_t>( PARALLEL_SEARCH_SPACE_GENERATION_SPLIT_DEPTH ), TREE_DEPTH - 1 );
+  if( split_depth == 0 )
+  {
+    generate_single_config_tree< TREE_DEPTH >( tree_id, tps... );
+    return;
+  }
+
+#ifdef PARALLEL_SEARCH_SPACE_GENERATION_THREADS
+  const size_t num_workers = PARALLEL_SEARCH_SPACE_GENERATION_THREADS;
+#else
+  const size_t num_workers = std::max( std::thread::hardware_concurrency(), 1u );
+#endif
+
+  // provide a value slot per worker in each TP of the tree
+  auto set_num_workers = { ( tps._act_elem->set_num_workers( num_workers ), 0 )... };
+  static_cast<void>( set_num_workers );
+
+  std::atomic<size_t>                                                        next_prefix( 0 );
+  std::vector< std::vector< std::pair<size_t, search_space_t::tree_type> > > subtrees_of_workers( num_workers );
+  std::vector< std::exception_ptr >                                          errors_of_workers( num_workers );
+  std::vector< std::thread >                                                 workers;
+  for( size_t worker_id = 1 ; worker_id <= num_workers ; ++worker_id )
+  {
+    // each worker iterates over its own copies of the TPs' ranges
+    workers.emplace_back( [ &, worker_id, tps... ]() mutable {
+      detail::generation_worker_id() = worker_id;
+      try
+      {
+        subtree_generation_state state{ split_depth, next_prefix, next_prefix++, 0, subtrees_of_workers[ worker_id - 1 ] };
+        generate_config_subtrees< TREE_DEPTH, TREE_DEPTH >( state, tps... );
+      }
+      catch( ... )
+      {
+        errors_of_workers[ worker_id - 1 ] = std::current_exception();
+      }
+      detail::generation_worker_id() = 0;
+    } );
+  }
+
+  for( auto& worker : workers )
+    worker.join();
+
+  // an exception of a constraint or a range is passed on to the caller
+  for( const auto& error : errors_of_workers )
+    if( error )
+      std::rethrow_exception( error );
+
+  // merge subtrees in prefix order
+  std::map< size_t, search_space_t::tree_type > subtrees;
+  for( auto& subtrees_of_worker : subtrees_of_workers )
+    for( auto& subtree : subtrees_of_worker )
+      subtrees.emplace( std::move( subtree ) );
+
+  auto& tree = _search_space.tree( tree_id );
+  for( auto& subtree : subtrees )
+    tree.append( std::move( subtree.second ) );
+}
+
+
+template< size_t TREE_DEPTH, size_t REMAINING_DEPTH, typename TP, typename... Ts, std::enable_if_t<( REMAINING_DEPTH > 0 )>* >
+void exploration_engine::generate_config_subtrees( subtree_generation_state& state, TP& tp, Ts&... tps )
+{
+  const size_t depth = TREE_DEPTH - REMAINING_DEPTH + 1;
+
+  typename TP::type value;
+  while( tp.get_next_value( value ) )
+  {
+    if( depth == state.split_depth )
+    {
+      // skip prefixes that are not claimed by this worker
+      if( state.num_visited_prefixes++ != state.claimed_prefix )
+        continue;
+
+      state.subtrees.emplace_back( state.claimed_prefix, search_space_t::tree_type() );
+      state.claimed_prefix = state.next_prefix++;
+    }
+
+    auto value_tp_pair = std::make_pair( value, static_cast<void*>( tp._act_elem->value_ptr() ) );
+    generate_config_subtrees< TREE_DEPTH, REMAINING_DEPTH-1 >( state, tps..., value_tp_pair );
+  }
+}
+
+
+template< size_t TREE_DEPTH, size_t REMAINING_DEPTH, typename... Ts, std::enable_if_t<( REMAINING_DEPTH == 0 )>* >
+void exploration_engine::generate_config_subtrees( subtree_generation_state& state, const Ts&... values )
+{
+  state.subtrees.back().second.insert( values... );
+}
+#endif
+#endif
 
 
 template< typename T, typename... Ts >
@@ -0,0 +1,158 @@
+#ifndef index_strides_h
+#define index_strides_h
+
+#include <cstdint>
+#include <climits>
+#include <string>
+#include <vector>
+
+#include "../big_int.hpp"
+
+namespace atf
+{
+
+namespace detail
+{
+
+#ifdef __SIZEOF_INT128__
+using uint128 = unsigned __int128;
+#endif
+
+
+// Strides of the trees of a search space in the 1D index space: the leaf of tree "t" selected by an index is
+// "( index / stride[ t ] ) % num_leafs[ t ]", where "stride[ t ]" is the product of the numbers of leafs of the trees after "t".
+// The strides are computed once after generation; indices are decoded with native integers if the search space size fits
+// into 64 (or 128) bits, and with "big_int" otherwise.
+class index_strides
+{
+  public:
+    index_strides()
+      : _num_leafs(), _num_configs( 0 ), _width( width_big ), _strides(), _strides_64()
+#ifdef __SIZEOF_INT128__
+      , _strides_128()
+#endif
+    {}
+
+
+    void compute( const std::vector<size_t>& num_leafs )
+    {
+      const size_t num_trees = num_leafs.size();
+      _num_leafs = num_leafs;
+
+      _strides.assign( num_trees, big_int( 1 ) );
+      for( int tree_id = static_cast<int>( num_trees ) - 2 ; tree_id >= 0 ; --tree_id )
+        _strides[ tree_id ] = _strides[ tree_id + 1 ] * big_int( num_leafs[ tree_id + 1 ] );
+      _num_configs = num_trees == 0 ? big_int( 1 ) : _strides[ 0 ] * big_int( num_leafs[ 0 ] );
+
+      _strides_64.clear();
+#ifdef __SIZEOF_INT128__
+      _strides_128.clear();
+#endif
+      if( _num_configs <= big_int( static_cast<unsigned long long>( ULLONG_MAX ) ) )
+      {
+        _width = width_64;
+        for( const auto& stride : _strides )
+          _strides_64.emplace_back( static_cast<unsigned long long>( stride ) );
+      }
+#ifdef __SIZEOF_INT128__
+      else if( _num_configs <= max_128() )
+      {
+        _width = width_128;
+        for( const auto& stride : _strides )
+          _strides_128.emplace_back( to_uint128( stride ) );
+      }
+#endif
+      else
+        _width = width_big;
+    }
+
+
+    size_t num_trees() const
+    {
+      return _num_leafs.size();
+    }
+
+
+    const big_int& num_configs() const
+    {
+      return _num_configs;
+    }
+
+
+    // calls "f( tree_id, leaf_id )" for each tree
+    template< typename callable >
+    void decode( const big_int& index, callable&& f ) const
+    {
+      switch( _width )
+      {
+        case width_64:
+        {
+          const std::uint64_t index_64 = static_cast<unsigned long long>( index );
+          for( size_t tree_id = 0 ; tree_id < _num_leafs.size() ; ++tree_id )
+            f( tree_id, static_cast<size_t>( index_64 / _strides_64[ tree_id ] % _num_leafs[ tree_id ] ) );
+          break;
+        }
+
+#ifdef __SIZEOF_INT128__
+        case width_128:
+        {
+          const uint128 index_128 = to_uint128( index );
+          for( size_t tree_id = 0 ; tree_id < _num_leafs.size() ; ++tree_id )
+            f( tree_id, static_cast<size_t>( index_128 / _strides_128[ tree_id ] % _num_leafs[ tree_id ] ) );
+          break;
+        }
+#endif
+
+        default:
+          for( size_t tree_id = 0 ; tree_id < _num_leafs.size() ; ++tree_id )
+            f( tree_id, static_cast<size_t>( ( index / _strides[ tree_id ] ) % big_int( _num_leafs[ tree_id ] ) ) );
+          break;
+      }
+    }
+
+    // index of the configuration that consists of leaf "leaf_ids[ t ]" of each tree "t" (inverse of "decode")
+    big_int encode( const std::vector<size_t>& leaf_ids ) const
+    {
+      if( _width == width_64 )
+      {
+        std::uint64_t index = 0;
+        for( size_t tree_id = 0 ; tree_id < _num_leafs.size() ; ++tree_id )
+          index += leaf_ids[ tree_id ] * _strides_64[ tree_id ];
+        return big_int( static_cast<unsigned long long>( index ) );
+      }
+
+      big_int index = 0;
+      for( size_t tree_id = 0 ; tree_id < _num_leafs.size() ; ++tree_id )
+        index = index + big_int( leaf_ids[ tree_id ] ) * _strides[ tree_id ];
+      return index;
+    }
+
+  private:
+    enum index_width { width_64, width_128, width_big };
+
+    std::vector< size_t >        _num_leafs;
+    big_int                      _num_configs;
+    index_width                  _width;
+    std::vector< big_int >       _strides;
+    std::vector< std::uint64_t > _strides_64;
+#ifdef __SIZEOF_INT128__
+    std::vector< uint128 >       _strides_128;
+
+    static const big_int& max_128()
+    {
+      static const big_int max = big_int( "340282366920938463463374607431768211455" );
+      return max;
+    }
+
+    static uint128 to_uint128( const big_int& value )
+    {
+      return static_cast<uint128>( value );
+    }
+#endif
+};
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* index_strides_h */
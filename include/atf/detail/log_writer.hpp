@@ -0,0 +1,430 @@
+#ifndef log_writer_h
+#define log_writer_h
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <unistd.h>
+#endif
+
+namespace atf
+{
+
+namespace detail
+{
+
+// Output stream for a log file whose rows are written by a background thread, such that the tuning loop never waits for the
+// disk. Formatted rows are handed over to the thread via a lock-free ring buffer (single producer, single consumer) when the
+// stream is flushed; the thread writes them in batches every "flush_interval" (or once the ring buffer is half full). Should
+// the ring buffer be full, rows are kept in a backlog of the producer until the thread catches up. Rows handed over are
+// written when the stream is closed, and when the process is terminated by SIGINT, SIGTERM, SIGHUP, or SIGABRT (rows that
+// the thread is writing at that moment may then be written twice; child processes forked from the tuner write no rows).
+// While log writers are open, the handlers of these signals are replaced process-wide via "sigaction"; the previous handlers
+// are restored when the last log writer is closed, and are invoked after the rows are written. At most 16 log writers can be
+// open at a time.
+class log_writer : public std::ostream
+{
+  public:
+    explicit log_writer( size_t capacity = 1 << 20, std::chrono::milliseconds flush_interval = std::chrono::milliseconds( 100 ) )
+      : std::ostream( nullptr ), _buffer( capacity, flush_interval )
+    {
+      rdbuf( &_buffer );
+    }
+
+    log_writer( const log_writer& ) = delete;
+
+    ~log_writer()
+    {
+      close();
+    }
+
+
+    // truncates the file at "path"
+    void open( const std::string& path )
+    {
+      close();
+      if( !_buffer.open( path ) )
+        setstate( std::ios::failbit );
+      else
+        clear();
+    }
+
+    bool is_open() const
+    {
+      return _buffer.is_open();
+    }
+
+    // writes all rows and waits for the background thread
+    void close()
+    {
+      if( _buffer.is_open() )
+        _buffer.close();
+    }
+
+
+    // current local time as ISO 8601 timestamp (as "timestamp_str"); the date and time up to the seconds is formatted once per second
+    log_writer& timestamp()
+    {
+      using namespace std::chrono;
+      const auto now    = system_clock::now();
+      const auto second = system_clock::to_time_t( now );
+      if( second != _timestamp_second || _timestamp_length == 0 )
+      {
+        std::tm bt = *std::localtime( &second );
+        _timestamp_length = std::strftime( _timestamp, sizeof( _timestamp ), "%Y-%m-%dT%H:%M:%S", &bt );
+        _timestamp_second = second;
+      }
+
+      const auto ms = static_cast<int>( duration_cast<milliseconds>( now.time_since_epoch() ).count() % 1000 );
+      char suffix[ 4 ] = { '.', static_cast<char>( '0' + ms / 100 ), static_cast<char>( '0' + ms / 10 % 10 ), static_cast<char>( '0' + ms % 10 ) };
+      write( _timestamp, _timestamp_length );
+      write( suffix, sizeof( suffix ) );
+      return *this;
+    }
+
+  private:
+    class ring_buffer : public std::streambuf
+    {
+      public:
+        ring_buffer( size_t capacity, std::chrono::milliseconds flush_interval )
+          : _capacity( round_up_to_power_of_2( std::max( capacity, static_cast<size_t>( 4096 ) ) ) ), _flush_interval( flush_interval ),
+            _ring(), _file( nullptr ), _written( 0 ), _claimed( 0 ), _released( 0 ), _backlog(), _thread(), _mutex(), _wakeup(), _closing( false )
+        {
+          setp( _row, _row + sizeof( _row ) );
+        }
+
+        ~ring_buffer()
+        {
+          close();
+        }
+
+
+        bool open( const std::string& path )
+        {
+          _file = std::fopen( path.c_str(), "w" );
+          if( _file == nullptr )
+            return false;
+          std::setvbuf( _file, nullptr, _IONBF, 0 ); // batches are written as a whole, also from signal handlers
+
+          _ring.reset( new char[ _capacity ] );
+          _written  = 0;
+          _claimed  = 0;
+          _released = 0;
+          _closing  = false;
+          _backlog.clear();
+          setp( _row, _row + sizeof( _row ) );
+
+          try
+          {
+            register_for_signals( this );
+          }
+          catch( ... )
+          {
+            std::fclose( _file );
+            _file = nullptr;
+            throw;
+          }
+          _thread = std::thread( [ this ]() { write_periodically(); } );
+          return true;
+        }
+
+        bool is_open() const
+        {
+          return _file != nullptr;
+        }
+
+        void close()
+        {
+          if( _file == nullptr )
+            return;
+
+          hand_over();
+          {
+            std::lock_guard<std::mutex> lock( _mutex );
+            _closing = true;
+          }
+          _wakeup.notify_one();
+          _thread.join();
+
+          // the backlog follows the rows in the ring buffer, which the thread has written before it stopped
+          unregister_for_signals( this );
+          if( !_backlog.empty() )
+            std::fwrite( _backlog.data(), 1, _backlog.size(), _file );
+          _backlog.clear();
+          std::fclose( _file );
+          _file = nullptr;
+        }
+
+        // Writes the rows handed over to the ring buffer but not written yet; only async-signal-safe operations. Rows that the
+        // thread is writing are waited for (up to 100ms); should the thread not finish them in time (e.g., as the signal handler
+        // runs on the thread), they are written again, such that rows may be duplicated, but are not lost.
+        void write_from_signal_handler()
+        {
+#if defined(__unix__) || defined(__APPLE__)
+          for( int i = 0 ; i < 100 && _claimed.load( std::memory_order_acquire ) != _released.load( std::memory_order_acquire ) ; ++i )
+          {
+            const struct timespec millisecond = { 0, 1000000 };
+            ::nanosleep( &millisecond, nullptr );
+          }
+
+          // claiming the rest keeps the thread from writing it as well
+          const size_t end   = _written.load( std::memory_order_acquire );
+          _claimed.exchange( end, std::memory_order_acq_rel );
+          const size_t begin = _released.load( std::memory_order_acquire );
+          if( begin != end )
+            write_range( begin, end, [ this ]( const char* data, size_t size ) {
+              while( size > 0 )
+              {
+                const ssize_t n = ::write( ::fileno( _file ), data, size );
+                if( n <= 0 )
+                  return;
+                data += n;
+                size -= static_cast<size_t>( n );
+              }
+            } );
+#endif
+        }
+
+      protected:
+        int_type overflow( int_type c ) override
+        {
+          hand_over();
+          if( !traits_type::eq_int_type( c, traits_type::eof() ) )
+          {
+            *pptr() = traits_type::to_char_type( c );
+            pbump( 1 );
+          }
+          return traits_type::not_eof( c );
+        }
+
+        // hands the formatted bytes over to the background thread (without waiting for them to be written)
+        int sync() override
+        {
+          hand_over();
+          return 0;
+        }
+
+      private:
+        const size_t               _capacity; // power of 2
+        std::chrono::milliseconds  _flush_interval;
+        std::unique_ptr<char[]>    _ring;
+        FILE*                      _file;
+
+        // positions in the stream of bytes that has passed through the ring buffer (the ring buffer holds [ _released, _written ))
+        std::atomic<size_t>        _written;  // handed over by the producer
+        std::atomic<size_t>        _claimed;  // claimed for writing by the thread (or by a signal handler)
+        std::atomic<size_t>        _released; // written by the thread, such that the producer may reuse the space
+
+        char                       _row[ 4096 ]; // bytes formatted by the producer since the last hand-over
+        std::string                _backlog;     // bytes that did not fit into the ring buffer, in order after the ring buffer's
+        std::thread                _thread;
+        std::mutex                 _mutex;
+        std::condition_variable    _wakeup;
+        bool                       _closing;
+
+        static size_t round_up_to_power_of_2( size_t n )
+        {
+          size_t power = 1;
+          while( power < n )
+            power *= 2;
+          return power;
+        }
+
+        void hand_over()
+        {
+          const char*  data = pbase();
+          const size_t size = static_cast<size_t>( pptr() - pbase() );
+          setp( _row, _row + sizeof( _row ) );
+          if( _file == nullptr )
+            return;
+
+          if( !_backlog.empty() )
+          {
+            _backlog.append( data, size );
+            const size_t n = push( _backlog.data(), _backlog.size() );
+            _backlog.erase( 0, n );
+          }
+          else
+          {
+            const size_t n = push( data, size );
+            _backlog.append( data + n, size - n );
+          }
+
+          if( _written.load( std::memory_order_relaxed ) - _released.load( std::memory_order_relaxed ) >= _capacity / 2 )
+            _wakeup.notify_one();
+        }
+
+        // copies as many bytes as fit into the ring buffer; returns their number
+        size_t push( const char* data, size_t size )
+        {
+          const size_t written = _written.load( std::memory_order_relaxed );
+          const size_t n       = std::min( size, _capacity - ( written - _released.load( std::memory_order_acquire ) ) );
+          const size_t offset  = written & ( _capacity - 1 );
+          const size_t first   = std::min( n, _capacity - offset );
+          std::memcpy( _ring.get() + offset, data, first );
+          std::memcpy( _ring.get(), data + first, n - first );
+          _written.store( written + n, std::memory_order_release );
+          return n;
+        }
+
+        template< typename write_t >
+        void write_range( size_t begin, size_t end, write_t&& write ) const
+        {
+          const size_t offset = begin & ( _capacity - 1 );
+          const size_t first  = std::min( end - begin, _capacity - offset );
+          write( _ring.get() + offset, first );
+          write( _ring.get(), end - begin - first );
+        }
+
+        void write_periodically()
+        {
+          std::unique_lock<std::mutex> lock( _mutex );
+          while( true )
+          {
+            _wakeup.wait_for( lock, _flush_interval, [ this ]() {
+              return _closing || _written.load( std::memory_order_relaxed ) - _released.load( std::memory_order_relaxed ) >= _capacity / 2;
+            } );
+            const bool closing = _closing;
+            lock.unlock();
+
+            size_t begin = _claimed.load( std::memory_order_acquire );
+            const size_t end = _written.load( std::memory_order_acquire );
+            if( begin != end && _claimed.compare_exchange_strong( begin, end ) )
+            {
+              write_range( begin, end, [ this ]( const char* data, size_t size ) { std::fwrite( data, 1, size, _file ); } );
+              _released.store( end, std::memory_order_release );
+            }
+
+            lock.lock();
+            if( closing )
+              return;
+          }
+        }
+
+
+        // log writers whose rows are written when the process is terminated by a signal
+        static constexpr size_t max_registered = 16;
+
+        static std::atomic<ring_buffer*>* registered()
+        {
+          static std::atomic<ring_buffer*> buffers[ max_registered ] = {};
+          return buffers;
+        }
+
+        static std::mutex& registration_mutex()
+        {
+          static std::mutex mutex;
+          return mutex;
+        }
+
+#if defined(__unix__) || defined(__APPLE__)
+        static const int* signals()
+        {
+          static const int numbers[] = { SIGINT, SIGTERM, SIGHUP, SIGABRT };
+          return numbers;
+        }
+        static constexpr size_t num_signals = 4;
+
+        static struct sigaction* previous_actions()
+        {
+          static struct sigaction actions[ num_signals ];
+          return actions;
+        }
+
+        // process that registered the log writers: a child forked from it (e.g., by "atf::isolated") inherits the handler and the
+        // ring buffers, but must not write the parent's rows
+        static pid_t& owner()
+        {
+          static pid_t pid = 0;
+          return pid;
+        }
+
+        static void handle_signal( int signal )
+        {
+          if( ::getpid() == owner() )
+            for( size_t i = 0 ; i < max_registered ; ++i )
+              if( ring_buffer* buffer = registered()[ i ].load() )
+                buffer->write_from_signal_handler();
+
+          // the signal's previous disposition (e.g., termination) takes effect once this handler returns
+          for( size_t i = 0 ; i < num_signals ; ++i )
+            if( signals()[ i ] == signal )
+              ::sigaction( signal, &previous_actions()[ i ], nullptr );
+          ::raise( signal );
+        }
+#endif
+
+        static size_t& num_registered()
+        {
+          static size_t number = 0;
+          return number;
+        }
+
+        static void register_for_signals( ring_buffer* buffer )
+        {
+          std::lock_guard<std::mutex> lock( registration_mutex() );
+          size_t i = 0;
+          for( ; i < max_registered ; ++i )
+          {
+            ring_buffer* expected = nullptr;
+            if( registered()[ i ].compare_exchange_strong( expected, buffer ) )
+              break;
+          }
+          if( i == max_registered )
+            throw std::runtime_error( "too many open log files: at most " + std::to_string( max_registered ) + " log writers can be open at a time" );
+
+#if defined(__unix__) || defined(__APPLE__)
+          if( num_registered()++ == 0 )
+          {
+            owner() = ::getpid();
+            struct sigaction action;
+            std::memset( &action, 0, sizeof( action ) );
+            action.sa_handler = &ring_buffer::handle_signal;
+            sigemptyset( &action.sa_mask );
+            for( size_t i = 0 ; i < num_signals ; ++i )
+              ::sigaction( signals()[ i ], &action, &previous_actions()[ i ] );
+          }
+#endif
+        }
+
+        static void unregister_for_signals( ring_buffer* buffer )
+        {
+          std::lock_guard<std::mutex> lock( registration_mutex() );
+          for( size_t i = 0 ; i < max_registered ; ++i )
+          {
+            ring_buffer* expected = buffer;
+            registered()[ i ].compare_exchange_strong( expected, nullptr );
+          }
+
+#if defined(__unix__) || defined(__APPLE__)
+          if( --num_registered() == 0 )
+            for( size_t i = 0 ; i < num_signals ; ++i )
+              ::sigaction( signals()[ i ], &previous_actions()[ i ], nullptr );
+#endif
+        }
+    };
+
+    ring_buffer  _buffer;
+    std::time_t  _timestamp_second = 0;
+    char         _timestamp[ 32 ];
+    size_t       _timestamp_length = 0;
+};
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* log_writer_h */
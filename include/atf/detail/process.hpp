@@ -0,0 +1,180 @@
+#ifndef process_h
+#define process_h
+
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <thread>
+#include <limits>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <mutex>
+#include <condition_variable>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+namespace atf
+{
+
+namespace detail
+{
+
+// outcome of a process run with a time limit
+struct process_result
+{
+  bool timed_out;
+  bool exited;    // normal termination (otherwise: killed by a signal, e.g., a crash)
+  int  exit_code;
+};
+
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// Waits for child "pid", the leader of its own process group; once "timeout_ms" have passed, the whole group (i.e., also the
+// processes started by the child) is killed by a watchdog thread. The child is waited for by a blocking "waitpid", such that
+// this function returns as soon as the child exits (cost functions time it).
+inline process_result wait_for_process_group( pid_t pid, double timeout_ms )
+{
+  std::mutex              mutex;
+  std::condition_variable child_exited;
+  bool                    exited    = false;
+  bool                    timed_out = false;
+  std::thread             watchdog;
+  if( timeout_ms != std::numeric_limits<double>::infinity() )
+  {
+    watchdog = std::thread( [ & ]() {
+      std::unique_lock<std::mutex> lock( mutex );
+      if( !child_exited.wait_for( lock, std::chrono::duration<double, std::milli>( timeout_ms ), [ & ]() { return exited; } ) )
+      {
+        timed_out = true;
+        ::kill( -pid, SIGKILL );
+      }
+    } );
+  }
+
+  int   status;
+  pid_t result;
+  while( ( result = ::waitpid( pid, &status, 0 ) ) < 0 && errno == EINTR )
+  {}
+
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    exited = true;
+  }
+  child_exited.notify_one();
+  if( watchdog.joinable() )
+    watchdog.join();
+
+  if( result != pid )
+    throw std::runtime_error( "cannot wait for evaluation process" );
+  if( timed_out )
+    return { true, false, 0 };
+  if( WIFEXITED( status ) )
+    return { false, true, WEXITSTATUS( status ) };
+  return { false, false, 0 };
+}
+
+
+// runs "command" via "/bin/sh -c" in a new process group
+inline process_result run_command( const std::string& command, double timeout_ms )
+{
+  const pid_t pid = ::fork();
+  if( pid < 0 )
+    throw std::runtime_error( "cannot start evaluation process" );
+
+  if( pid == 0 )
+  {
+    ::setpgid( 0, 0 );
+    ::execl( "/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>( nullptr ) );
+    ::_exit( 127 );
+  }
+
+  ::setpgid( pid, pid ); // also set by the child, whichever runs first
+  return wait_for_process_group( pid, timeout_ms );
+}
+
+
+// Runs "f" in a forked child process in a new process group, and returns the cost computed by "f" in "cost" (sent back via a
+// pipe). The child is forked from the (possibly multi-threaded) tuner: "f" must not depend on locks held by other threads.
+inline process_result run_in_child_process( const std::function<double()>& f, double timeout_ms, double& cost )
+{
+  int fds[ 2 ];
+  if( ::pipe( fds ) != 0 )
+    throw std::runtime_error( "cannot start evaluation process" );
+
+  const pid_t pid = ::fork();
+  if( pid < 0 )
+  {
+    ::close( fds[ 0 ] );
+    ::close( fds[ 1 ] );
+    throw std::runtime_error( "cannot start evaluation process" );
+  }
+
+  if( pid == 0 )
+  {
+    ::setpgid( 0, 0 );
+    ::close( fds[ 0 ] );
+    int exit_code = EXIT_FAILURE;
+    try
+    {
+      const double child_cost = f();
+      if( ::write( fds[ 1 ], &child_cost, sizeof( child_cost ) ) == sizeof( child_cost ) )
+        exit_code = EXIT_SUCCESS;
+    }
+    catch( ... )
+    {}
+    ::_exit( exit_code );
+  }
+
+  ::close( fds[ 1 ] );
+  ::setpgid( pid, pid );
+
+  process_result result;
+  try
+  {
+    result = wait_for_process_group( pid, timeout_ms );
+  }
+  catch( ... )
+  {
+    ::close( fds[ 0 ] );
+    throw;
+  }
+
+  // the cost fits into the pipe's buffer, such that the child has written it before exiting
+  if( result.exited && result.exit_code == EXIT_SUCCESS && ::read( fds[ 0 ], &cost, sizeof( cost ) ) != sizeof( cost ) )
+    result.exit_code = EXIT_FAILURE;
+  ::close( fds[ 0 ] );
+
+  return result;
+}
+
+#else
+
+inline process_result run_command( const std::string& command, double timeout_ms )
+{
+  if( timeout_ms != std::numeric_limits<double>::infinity() )
+    throw std::runtime_error( "evaluation timeouts require a POSIX system" );
+
+  const int ret = std::system( command.c_str() );
+  return { false, true, ret };
+}
+
+inline process_result run_in_child_process( const std::function<double()>& f, double timeout_ms, double& cost )
+{
+  throw std::runtime_error( "isolated evaluations require a POSIX system" );
+}
+
+#endif
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* process_h */
@@ -1,6 +1,8 @@
 #ifndef pso_particle_h
 #define pso_particle_h
 
+#include "../technique_state.hpp"
+
 namespace atf {
   namespace detail {
     namespace pso {
@@ -187,6 +189,32 @@ namespace atf {
           _pos = x_func(*this, best, dist);
         }
 
+        /**
+         * \brief Writes the particle's position, velocity, best position and best fitness to `out`.
+         *
+         * \param out   stream to write the state to
+         */
+        void save_state(std::ostream& out) const
+        {
+          save_value(out, _pos);
+          save_value(out, _velocity);
+          save_value(out, _best_pos);
+          save_value(out, _best_fitness);
+        }
+
+        /**
+         * \brief Restores a state written by `save_state`.
+         *
+         * \param in    stream to read the state from
+         */
+        void load_state(std::istream& in)
+        {
+          load_value(in, _pos);
+          load_value(in, _velocity);
+          load_value(in, _best_pos);
+          load_value(in, _best_fitness);
+        }
+
       private:
         /** Current position */
         coordinates _pos;
@@ -177,6 +177,36 @@ namespace atf {
         }
       }
 
+      /**
+       * \brief Writes the swarm's random engine, counters and particles to `out`.
+       *
+       * \param out   stream to write the state to
+       */
+      void save_state(std::ostream& out) const
+      {
+        save_value(out, _rng);
+        save_value(out, _best_idx);
+        save_value(out, _invalid_configs);
+        for (const particle& p : _particles) {
+          p.save_state(out);
+        }
+      }
+
+      /**
+       * \brief Restores a state written by `save_state`.
+       *
+       * \param in    stream to read the state from
+       */
+      void load_state(std::istream& in)
+      {
+        load_value(in, _rng);
+        load_value(in, _best_idx);
+        load_value(in, _invalid_configs);
+        for (particle& p : _particles) {
+          p.load_state(in);
+        }
+      }
+
     private:
 
       /**
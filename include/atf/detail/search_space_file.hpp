@@ -0,0 +1,345 @@
+#ifndef search_space_file_h
+#define search_space_file_h
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "binary_io.hpp"
+#include "../value_type.hpp"
+
+namespace atf
+{
+
+namespace detail
+{
+
+// 64-bit FNV-1a hash, used as key of search space files
+class fnv1a_hash
+{
+  public:
+    void add( const void* data, size_t size )
+    {
+      auto bytes = static_cast<const unsigned char*>( data );
+      for( size_t i = 0 ; i < size ; ++i )
+      {
+        _hash ^= bytes[ i ];
+        _hash *= 0x100000001b3ull;
+      }
+    }
+
+    void add( const std::string& str )
+    {
+      add( static_cast<std::uint64_t>( str.size() ) );
+      add( str.data(), str.size() );
+    }
+
+    void add( std::uint64_t value )
+    {
+      add( &value, sizeof( value ) );
+    }
+
+    void add( const value_type& value )
+    {
+      add( static_cast<std::uint64_t>( value.type_id() ) );
+      switch( value.type_id() )
+      {
+        case value_type::bool_t:
+        case value_type::size_t_t:
+          add( static_cast<std::uint64_t>( value.size_t_val() ) );
+          break;
+
+        case value_type::int_t:
+          add( static_cast<std::uint64_t>( static_cast<std::int64_t>( value.int_val() ) ) );
+          break;
+
+        case value_type::float_t:
+        case value_type::double_t:
+        {
+          double d = value.type_id() == value_type::float_t ? value.float_val() : value.double_val();
+          add( &d, sizeof( d ) );
+          break;
+        }
+
+        case value_type::string_t:
+          add( value.string_val() );
+          break;
+
+        default:
+          break;
+      }
+    }
+
+    std::uint64_t value() const
+    {
+      return _hash;
+    }
+
+  private:
+    std::uint64_t _hash = 0xcbf29ce484222325ull;
+};
+
+
+// read-only file mapped into memory (read into an aligned buffer on platforms without "mmap")
+class mapped_file
+{
+  public:
+    explicit mapped_file( const std::string& path )
+      : _data( nullptr ), _size( 0 )
+    {
+#if defined(__unix__) || defined(__APPLE__)
+      int fd = ::open( path.c_str(), O_RDONLY );
+      if( fd < 0 )
+        throw std::runtime_error( "cannot open search space file: " + path );
+
+      struct stat st;
+      if( ::fstat( fd, &st ) != 0 )
+      {
+        ::close( fd );
+        throw std::runtime_error( "cannot stat search space file: " + path );
+      }
+      _size = static_cast<size_t>( st.st_size );
+
+      if( _size > 0 )
+      {
+        void* addr = ::mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if( addr == MAP_FAILED )
+        {
+          ::close( fd );
+          throw std::runtime_error( "cannot map search space file: " + path );
+        }
+        _data = static_cast<const char*>( addr );
+      }
+      ::close( fd );
+#else
+      std::ifstream in( path, std::ios::binary | std::ios::ate );
+      if( !in )
+        throw std::runtime_error( "cannot open search space file: " + path );
+
+      _size = static_cast<size_t>( in.tellg() );
+      _buffer.reset( new std::uint64_t[ ( _size + 7 ) / 8 ] );
+      in.seekg( 0 );
+      in.read( reinterpret_cast<char*>( _buffer.get() ), _size );
+      _data = reinterpret_cast<const char*>( _buffer.get() );
+#endif
+    }
+
+    mapped_file( const mapped_file& ) = delete;
+    mapped_file& operator=( const mapped_file& ) = delete;
+
+    ~mapped_file()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+      if( _data != nullptr )
+        ::munmap( const_cast<char*>( _data ), _size );
+#endif
+    }
+
+    const char* data() const
+    {
+      return _data;
+    }
+
+    size_t size() const
+    {
+      return _size;
+    }
+
+  private:
+    const char*                      _data;
+    size_t                           _size;
+#if !( defined(__unix__) || defined(__APPLE__) )
+    std::unique_ptr<std::uint64_t[]> _buffer;
+#endif
+};
+
+
+// thrown by "search_space_file_reader" for files that are truncated or otherwise corrupt
+class corrupt_search_space_file : public std::runtime_error
+{
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+
+// sequential reader of a mapped file; every item starts at an 8-byte boundary (see "binary_io.hpp"), so arrays can be used in place
+class search_space_file_reader
+{
+  public:
+    explicit search_space_file_reader( const mapped_file& file )
+      : _file( file ), _pos( 0 )
+    {}
+
+    std::uint64_t read_uint64()
+    {
+      std::uint64_t value;
+      std::memcpy( &value, read_bytes( sizeof( value ) ), sizeof( value ) );
+      return value;
+    }
+
+    // number of items that follow; at most the number of remaining bytes
+    size_t read_size()
+    {
+      auto size = read_uint64();
+      if( size > remaining() )
+        throw corrupt_search_space_file( "search space file is corrupt" );
+      return static_cast<size_t>( size );
+    }
+
+    std::string read_string()
+    {
+      auto size = read_size();
+      return std::string( read_bytes( size ), size );
+    }
+
+    value_type read_value()
+    {
+      auto type_id = static_cast<value_type::type_id_t>( read_uint64() );
+      switch( type_id )
+      {
+        case value_type::bool_t:
+          return value_type( read_uint64() != 0 );
+
+        case value_type::int_t:
+          return value_type( static_cast<int>( static_cast<std::int64_t>( read_uint64() ) ) );
+
+        case value_type::size_t_t:
+          return value_type( static_cast<size_t>( read_uint64() ) );
+
+        case value_type::float_t:
+        {
+          double d;
+          std::memcpy( &d, read_bytes( sizeof( d ) ), sizeof( d ) );
+          return value_type( static_cast<float>( d ) );
+        }
+
+        case value_type::double_t:
+        {
+          double d;
+          std::memcpy( &d, read_bytes( sizeof( d ) ), sizeof( d ) );
+          return value_type( d );
+        }
+
+        case value_type::string_t:
+          return value_type( read_string() );
+
+        default:
+          throw corrupt_search_space_file( "invalid value in search space file" );
+      }
+    }
+
+    template< typename T >
+    const T* read_array( size_t size )
+    {
+      return reinterpret_cast<const T*>( read_bytes( size * sizeof( T ) ) );
+    }
+
+  private:
+    const mapped_file& _file;
+    size_t             _pos;
+
+    size_t remaining() const
+    {
+      return _pos < _file.size() ? _file.size() - _pos : 0;
+    }
+
+    const char* read_bytes( size_t size )
+    {
+      if( size > remaining() )
+        throw corrupt_search_space_file( "search space file is truncated" );
+
+      const char* bytes = _file.data() + _pos;
+      _pos += padded_size( size );
+      return bytes;
+    }
+};
+
+
+// sequential writer of a search space file (counterpart of "search_space_file_reader")
+class search_space_file_writer
+{
+  public:
+    explicit search_space_file_writer( const std::string& path )
+      : _out( path, std::ios::binary | std::ios::trunc )
+    {
+      if( !_out )
+        throw std::runtime_error( "cannot write search space file: " + path );
+    }
+
+    void write_uint64( std::uint64_t value )
+    {
+      detail::write_uint64( _out, value );
+    }
+
+    void write_string( const std::string& str )
+    {
+      detail::write_string( _out, str );
+    }
+
+    void write_value( const value_type& value )
+    {
+      write_uint64( value.type_id() );
+      switch( value.type_id() )
+      {
+        case value_type::bool_t:
+        case value_type::size_t_t:
+          write_uint64( value.size_t_val() );
+          break;
+
+        case value_type::int_t:
+          write_uint64( static_cast<std::uint64_t>( static_cast<std::int64_t>( value.int_val() ) ) );
+          break;
+
+        case value_type::float_t:
+        case value_type::double_t:
+        {
+          double d = value.type_id() == value_type::float_t ? value.float_val() : value.double_val();
+          write_bytes( &d, sizeof( d ) );
+          break;
+        }
+
+        case value_type::string_t:
+          write_string( value.string_val() );
+          break;
+
+        default:
+          throw std::runtime_error( "invalid value in search space" );
+      }
+    }
+
+    template< typename T >
+    void write_array( const T* data, size_t size )
+    {
+      write_bytes( data, size * sizeof( T ) );
+    }
+
+    bool good() const
+    {
+      return _out.good();
+    }
+
+  private:
+    std::ofstream _out;
+
+    void write_bytes( const void* data, size_t size )
+    {
+      detail::write_bytes( _out, data, size );
+    }
+};
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* search_space_file_h */
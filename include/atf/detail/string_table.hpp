@@ -0,0 +1,61 @@
+#ifndef string_table_h
+#define string_table_h
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <shared_mutex>
+
+namespace atf
+{
+
+namespace detail
+{
+
+// Table of the string values of TPs: "value_type" refers to an interned string instead of holding a copy, such that values
+// are trivially copyable. Equal strings are interned once; interned strings are never removed, so that references to them
+// stay valid for the lifetime of the process.
+class string_table
+{
+  public:
+    static const std::string* intern( const std::string& s )
+    {
+      auto& table = instance();
+
+      {
+        std::shared_lock<std::shared_timed_mutex> lock( table._mutex );
+        auto it = table._strings_by_value.find( s );
+        if( it != table._strings_by_value.end() )
+          return it->second;
+      }
+
+      std::unique_lock<std::shared_timed_mutex> lock( table._mutex );
+      auto it = table._strings_by_value.find( s );
+      if( it != table._strings_by_value.end() )
+        return it->second;
+
+      table._strings.emplace_back( s );
+      const std::string* interned = &table._strings.back();
+      table._strings_by_value.emplace( s, interned );
+      return interned;
+    }
+
+  private:
+    std::deque< std::string >                                _strings; // deque: references stay valid on insertion
+    std::unordered_map< std::string, const std::string* >    _strings_by_value;
+    std::shared_timed_mutex                                  _mutex;
+
+    // never destroyed, so that values can be read during static destruction
+    static string_table& instance()
+    {
+      static string_table* table = new string_table();
+      return *table;
+    }
+};
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* string_table_h */
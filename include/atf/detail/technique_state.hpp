@@ -0,0 +1,115 @@
+#ifndef technique_state_h
+#define technique_state_h
+
+#include <cstdlib>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace atf
+{
+
+namespace detail
+{
+
+// Reading and writing of search technique states (see "search_technique::save_state"): values are written as text separated
+// by spaces; floating point values are written with enough digits to be read back exactly.
+
+template< typename T >
+void save_value( std::ostream& out, const T& value );
+
+template< typename T1, typename T2 >
+void save_value( std::ostream& out, const std::pair<T1, T2>& value );
+
+template< typename T >
+void save_value( std::ostream& out, const std::vector<T>& values );
+
+inline void save_value( std::ostream& out, double value );
+
+template< typename T >
+void load_value( std::istream& in, T& value );
+
+template< typename T1, typename T2 >
+void load_value( std::istream& in, std::pair<T1, T2>& value );
+
+template< typename T >
+void load_value( std::istream& in, std::vector<T>& values );
+
+inline void load_value( std::istream& in, double& value );
+
+
+template< typename T >
+void save_value( std::ostream& out, const T& value )
+{
+  out << value << ' ';
+}
+
+template< typename T1, typename T2 >
+void save_value( std::ostream& out, const std::pair<T1, T2>& value )
+{
+  save_value( out, value.first );
+  save_value( out, value.second );
+}
+
+template< typename T >
+void save_value( std::ostream& out, const std::vector<T>& values )
+{
+  out << values.size() << ' ';
+  for( const auto& value : values )
+    save_value( out, value );
+}
+
+inline void save_value( std::ostream& out, double value )
+{
+  const auto precision = out.precision( std::numeric_limits<double>::max_digits10 );
+  out << value << ' ';
+  out.precision( precision );
+}
+
+
+// whitespace is skipped explicitly, as some random engines read their state with "skipws" unset
+template< typename T >
+void load_value( std::istream& in, T& value )
+{
+  if( !( in >> std::ws >> value ) )
+    throw std::runtime_error( "invalid search technique state" );
+}
+
+template< typename T1, typename T2 >
+void load_value( std::istream& in, std::pair<T1, T2>& value )
+{
+  load_value( in, value.first );
+  load_value( in, value.second );
+}
+
+template< typename T >
+void load_value( std::istream& in, std::vector<T>& values )
+{
+  size_t size;
+  load_value( in, size );
+  values.resize( size );
+  for( auto& value : values )
+    load_value( in, value );
+}
+
+// "strtod" also reads the infinities and NaNs written by "operator<<"
+inline void load_value( std::istream& in, double& value )
+{
+  std::string token;
+  load_value( in, token );
+
+  char* end = nullptr;
+  value = std::strtod( token.c_str(), &end );
+  if( *end != '\0' )
+    throw std::runtime_error( "invalid search technique state" );
+}
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* technique_state_h */
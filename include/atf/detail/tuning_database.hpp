@@ -0,0 +1,211 @@
+#ifndef tuning_database_h
+#define tuning_database_h
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#include "binary_io.hpp"
+#include "../big_int.hpp"
+#include "../tuning_status.hpp"
+
+namespace atf
+{
+
+namespace detail
+{
+
+// evaluation stored in a tuning database
+struct tuning_record
+{
+  big_int       index;        // canonical index of the configuration in the search space
+  cost_t        cost;
+  bool          failed;
+  bool          timed_out;
+  bool          cache_hit;
+  std::int64_t  timestamp_ns; // since the epoch of "std::chrono::system_clock"
+  objective_vector objectives; // empty: no objectives, or failed
+};
+
+
+// Append-only file of the evaluations of a tuning run: a header identifying the search space, followed by one record per
+// evaluation. Each record is flushed when appended and ends with a marker, such that a record torn by a crash is detected
+// when the file is read and cut off before new records are appended.
+class tuning_database
+{
+  public:
+    tuning_database()
+      : _out()
+    {}
+
+    tuning_database( const tuning_database& )
+      : _out()
+    {}
+
+
+    // opens the database at "path" for the search space identified by "search_space_id"; if "resume" and the file exists,
+    // its records are returned and new records are appended, otherwise the file is created anew
+    std::vector<tuning_record> open( const std::string& path, std::uint64_t search_space_id, bool resume )
+    {
+      close();
+
+      std::vector<tuning_record> records;
+      std::uint64_t              valid_size = 0;
+      std::ifstream              in( path, std::ios::binary );
+      const bool                 exists = resume && in.good();
+      if( exists )
+      {
+        if( read_string( in ) != file_magic() )
+          throw std::runtime_error( "not a tuning database: " + path );
+        std::uint64_t file_search_space_id;
+        if( !read_uint64( in, file_search_space_id ) || file_search_space_id != search_space_id )
+          throw std::runtime_error( "tuning database was recorded for other tuning parameters: " + path );
+        valid_size = static_cast<std::uint64_t>( in.tellg() );
+
+        tuning_record record;
+        while( read_record( in, record ) )
+        {
+          records.emplace_back( record );
+          valid_size = static_cast<std::uint64_t>( in.tellg() );
+        }
+        in.close();
+
+        cut_off( path, valid_size );
+        _out.open( path, std::ios::binary | std::ios::app );
+      }
+      else
+      {
+        in.close();
+        _out.open( path, std::ios::binary | std::ios::trunc );
+        write_string( file_magic() );
+        write_uint64( search_space_id );
+        _out.flush();
+      }
+
+      if( !_out )
+        throw std::runtime_error( "cannot write tuning database: " + path );
+
+      return records;
+    }
+
+
+    bool is_open() const
+    {
+      return _out.is_open();
+    }
+
+
+    void append( const tuning_record& record )
+    {
+      write_uint64( ( record.failed ? 1 : 0 ) | ( record.cache_hit ? 2 : 0 ) | ( record.timed_out ? 4 : 0 ) );
+      write_bytes( &record.cost, sizeof( record.cost ) );
+      write_uint64( static_cast<std::uint64_t>( record.timestamp_ns ) );
+      write_string( static_cast<std::string>( record.index ) );
+      write_uint64( record.objectives.size() );
+      for( const auto& objective : record.objectives )
+        write_bytes( &objective, sizeof( objective ) );
+      write_uint64( record_marker() );
+      _out.flush();
+    }
+
+
+    void close()
+    {
+      if( _out.is_open() )
+        _out.close();
+    }
+
+  private:
+    std::ofstream _out;
+
+    static std::string file_magic()
+    {
+      return "ATF tuning database v2"; // v2: records hold objective vectors
+    }
+
+    static std::uint64_t record_marker()
+    {
+      return 0x41544652454344ull; // "ATFRECD"
+    }
+
+    void write_bytes( const void* data, size_t size )
+    {
+      detail::write_bytes( _out, data, size );
+    }
+
+    void write_uint64( std::uint64_t value )
+    {
+      detail::write_uint64( _out, value );
+    }
+
+    void write_string( const std::string& str )
+    {
+      detail::write_string( _out, str );
+    }
+
+    // returns false at the end of the file or at a torn record
+    static bool read_record( std::ifstream& in, tuning_record& record )
+    {
+      std::uint64_t flags, timestamp, marker;
+      if( !read_uint64( in, flags ) || !read_bytes( in, &record.cost, sizeof( record.cost ) ) || !read_uint64( in, timestamp ) )
+        return false;
+
+      const std::string index = read_string( in );
+      if( index.empty() || index.find_first_not_of( "0123456789" ) != std::string::npos )
+        return false;
+
+      std::uint64_t num_objectives;
+      if( !read_uint64( in, num_objectives ) || num_objectives > ( 1u << 16 ) )
+        return false;
+      record.objectives.resize( static_cast<size_t>( num_objectives ) );
+      for( auto& objective : record.objectives )
+        if( !read_bytes( in, &objective, sizeof( objective ) ) )
+          return false;
+
+      if( !read_uint64( in, marker ) || marker != record_marker() )
+        return false;
+
+      record.index        = big_int( index.c_str() );
+      record.failed       = ( flags & 1 ) != 0;
+      record.cache_hit    = ( flags & 2 ) != 0;
+      record.timed_out    = ( flags & 4 ) != 0;
+      record.timestamp_ns = static_cast<std::int64_t>( timestamp );
+      return true;
+    }
+
+    // removes a torn record at the end of the file
+    static void cut_off( const std::string& path, std::uint64_t size )
+    {
+      std::ifstream in( path, std::ios::binary | std::ios::ate );
+      const auto file_size = static_cast<std::uint64_t>( in.tellg() );
+      in.close();
+      if( file_size == size )
+        return;
+
+#if defined(__unix__) || defined(__APPLE__)
+      if( ::truncate( path.c_str(), static_cast<off_t>( size ) ) != 0 )
+        throw std::runtime_error( "cannot repair tuning database: " + path );
+#else
+      std::ifstream src( path, std::ios::binary );
+      std::vector<char> bytes( static_cast<size_t>( size ) );
+      src.read( bytes.data(), bytes.size() );
+      src.close();
+      std::ofstream dst( path, std::ios::binary | std::ios::trunc );
+      dst.write( bytes.data(), bytes.size() );
+      if( !dst )
+        throw std::runtime_error( "cannot repair tuning database: " + path );
+#endif
+    }
+};
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* tuning_database_h */
@@ -0,0 +1,110 @@
+#ifndef worker_pool_h
+#define worker_pool_h
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+#include "../trace.hpp"
+
+namespace atf
+{
+
+namespace detail
+{
+
+// Fixed set of threads that execute the calls "f( 0 ), ..., f( n-1 )" of a task; the threads are started once and reused
+// for all tasks. Calls are claimed one at a time, such that long calls do not hold back the remaining ones.
+class worker_pool
+{
+  public:
+    explicit worker_pool( size_t num_workers )
+      : _threads(), _mutex(), _task_available(), _task_done(), _task( nullptr ), _num_calls( 0 ), _next_call( 0 ),
+        _task_id( 0 ), _num_finished_workers( 0 ), _stop( false )
+    {
+      for( size_t i = 0 ; i < num_workers ; ++i )
+        _threads.emplace_back( [ this ]() { work(); } );
+    }
+
+    worker_pool( const worker_pool& ) = delete;
+    worker_pool& operator=( const worker_pool& ) = delete;
+
+    ~worker_pool()
+    {
+      {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _stop = true;
+      }
+      _task_available.notify_all();
+
+      for( auto& thread : _threads )
+        thread.join();
+    }
+
+
+    size_t num_workers() const
+    {
+      return _threads.size();
+    }
+
+
+    // executes "f( i )" for i = 0, ..., num_calls-1 on the workers and returns when all calls have returned
+    void run( size_t num_calls, const std::function<void( size_t )>& f )
+    {
+      std::unique_lock<std::mutex> lock( _mutex );
+      _task                 = &f;
+      _num_calls            = num_calls;
+      _next_call            = 0;
+      _num_finished_workers = 0;
+      ++_task_id;
+      _task_available.notify_all();
+
+      _task_done.wait( lock, [ & ]() { return _num_finished_workers == _threads.size(); } );
+      _task = nullptr;
+    }
+
+  private:
+    std::vector< std::thread >                _threads;
+    std::mutex                                _mutex;
+    std::condition_variable                   _task_available;
+    std::condition_variable                   _task_done;
+    const std::function<void( size_t )>*      _task;
+    size_t                                    _num_calls;
+    std::atomic<size_t>                       _next_call;
+    size_t                                    _task_id;              // incremented per task
+    size_t                                    _num_finished_workers; // of the current task
+    bool                                      _stop;
+
+    void work()
+    {
+      tracer::instance().name_thread( "worker" );
+      size_t last_task_id = 0;
+      while( true )
+      {
+        std::unique_lock<std::mutex> lock( _mutex );
+        _task_available.wait( lock, [ & ]() { return _stop || _task_id != last_task_id; } );
+        if( _stop )
+          return;
+        last_task_id = _task_id;
+        const auto&  f         = *_task;
+        const size_t num_calls = _num_calls;
+        lock.unlock();
+
+        for( size_t i = _next_call++ ; i < num_calls ; i = _next_call++ )
+          f( i );
+
+        lock.lock();
+        if( ++_num_finished_workers == _threads.size() )
+          _task_done.notify_one();
+      }
+    }
+};
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* worker_pool_h */
@@ -2,8 +2,10 @@
 #define differential_evolution_h
 
 #include <random>
+#include <algorithm>
 
 #include "search_technique.hpp"
+#include "detail/technique_state.hpp"
 
 /** number of vectors of the population with a minimum of 4 */
 #define NUM_VECTORS     30
@@ -33,41 +35,78 @@ class differential_evolution : public search_technique
       _trial_vector = random_coordinates(_dimensionality);
     }
 
+    // a point per vector of the batch (the vectors from "_current_vec" up to the end of the generation): the vector itself if
+    // its cost is unknown, and its trial vector otherwise
     std::set<coordinates> get_next_coordinates() override
     {
-      if(_population_costs.at(_current_vec) == -1){
-        return { clamp_coordinates_capped( _vector_population.at(_current_vec) ) };
-      } else {
-        setTrialVector();
-        return { clamp_coordinates_capped( _trial_vector ) };
+      _batch.clear();
+      std::set<coordinates> points;
+      for(size_t vec = _current_vec; vec < static_cast<size_t>(NUM_VECTORS) && _batch.size() < _batch_size; ++vec){
+        if(_population_costs.at(vec) == -1){
+          _batch.push_back( { _vector_population.at(vec), clamp_coordinates_capped( _vector_population.at(vec) ) } );
+        } else {
+          setTrialVector(vec);
+          _batch.push_back( { _trial_vector, clamp_coordinates_capped( _trial_vector ) } );
+        }
+        points.insert( _batch.back().point );
       }
+      return points;
     }
 
     void report_costs( const std::map<coordinates, cost_t>& costs ) override
     {
-      cost_t cost = costs.begin()->second;
-      if(_population_costs.at(_current_vec) == -1){
-        if(cost == std::numeric_limits<atf::cost_t>::max()){
-          _vector_population.at(_current_vec) = random_coordinates(_dimensionality);
+      for(const auto& requested : _batch){
+        auto cost_it = costs.find( requested.point );
+        if(cost_it != costs.end()){
+          cost_t cost = cost_it->second;
+          if(_population_costs.at(_current_vec) == -1){
+            if(cost == std::numeric_limits<atf::cost_t>::max()){
+              _vector_population.at(_current_vec) = random_coordinates(_dimensionality);
+            }
+            else
+              _population_costs.at(_current_vec) = cost;
+          }
+          else if(cost <= _population_costs.at(_current_vec)){
+            _vector_population.at(_current_vec) = requested.vector;
+            _population_costs.at(_current_vec) = cost;
+          }
         }
-        else
-          _population_costs.at(_current_vec) = cost;
-      }
-      else if(cost <= _population_costs.at(_current_vec)){
-        _vector_population.at(_current_vec) = _trial_vector;
-        _population_costs.at(_current_vec) = cost;
-      }
 
-      if(_current_vec < NUM_VECTORS -1)
-        _current_vec++;
-      else{
-        _current_vec = 0;           //Next generation
+        if(_current_vec < NUM_VECTORS -1)
+          _current_vec++;
+        else{
+          _current_vec = 0;           //Next generation
+        }
       }
+      _batch.clear();
+    }
+
+    void set_batch_size( size_t batch_size ) override
+    {
+      _batch_size = std::max( batch_size, size_t( 1 ) );
     }
 
     void finalize() override
     {}
 
+    void save_state( std::ostream& out ) const override
+    {
+      detail::save_value( out, _generator );
+      detail::save_value( out, _vector_population );
+      detail::save_value( out, _trial_vector );
+      detail::save_value( out, _population_costs );
+      detail::save_value( out, _current_vec );
+    }
+
+    void load_state( std::istream& in ) override
+    {
+      detail::load_value( in, _generator );
+      detail::load_value( in, _vector_population );
+      detail::load_value( in, _trial_vector );
+      detail::load_value( in, _population_costs );
+      detail::load_value( in, _current_vec );
+    }
+
   private:
     size_t                                 _dimensionality;
     /** generator to produce random values */
@@ -80,6 +119,15 @@ class differential_evolution : public search_technique
     std::vector<cost_t>                    _population_costs;
     /** counter of the vectors of population */
     size_t                                 _current_vec;
+    /** maximum number of vectors per request */
+    size_t                                 _batch_size = 1;
+    /** vectors of the current request (trial vectors, or vectors of unknown cost) and their requested points */
+    struct requested_vector
+    {
+      coordinates vector;
+      coordinates point;
+    };
+    std::vector<requested_vector>          _batch;
 
     static unsigned int random_seed()
     {
@@ -94,13 +142,13 @@ class differential_evolution : public search_technique
       }
     }
 
-    int* random_vectors() {
+    int* random_vectors(size_t current_vec) {
       std::uniform_int_distribution<int>  mutation_distribution = std::uniform_int_distribution<int>( 0, static_cast<int>(NUM_VECTORS -1) );
       int *vecs = new int[NUM_MUT_VECTORS];
       for(int i = 0; i < NUM_MUT_VECTORS; i++){
         vecs[i] = mutation_distribution(_generator);
         for(int j = 0; j<i; j++){
-          if( (vecs[i] == vecs[j] && i != j) || vecs[i] == _current_vec){
+          if( (vecs[i] == vecs[j] && i != j) || vecs[i] == static_cast<int>(current_vec)){
             vecs[i] = mutation_distribution(_generator);
             j=-1;
           }
@@ -109,7 +157,7 @@ class differential_evolution : public search_technique
       return vecs;
     }
 
-    void setTrialVector() {
+    void setTrialVector(size_t current_vec) {
       int random_param, *mutation_vec_indizes,loop_count=0;
       std::uniform_int_distribution<int> recombi_distribution = std::uniform_int_distribution<int>(0, static_cast<int>(_dimensionality - 1));
       std::uniform_real_distribution<double> cr_distribution = std::uniform_real_distribution<double>(0,static_cast<double>( 1.0 ));
@@ -117,13 +165,13 @@ class differential_evolution : public search_technique
       do {
         loop_count++;
         random_param = recombi_distribution(_generator);
-        mutation_vec_indizes = random_vectors();
+        mutation_vec_indizes = random_vectors(current_vec);
 
         for (int i = 0; i < _dimensionality; i++) {
           if (cr_distribution(_generator) <= CR || i == random_param)
             _trial_vector[i] = getDonorVector(i, mutation_vec_indizes);
           else
-            _trial_vector[i] = _vector_population.at(_current_vec)[i];
+            _trial_vector[i] = _vector_population.at(current_vec)[i];
         }
 
       } while (! valid_coordinates(_trial_vector) && loop_count < INVALID_RETRIES);
@@ -2,7 +2,11 @@
 #ifndef exhaustive_h
 #define exhaustive_h
 
+#include <climits>
+#include <algorithm>
+
 #include "search_technique_1d.hpp"
+#include "detail/technique_state.hpp"
 
 namespace atf
 {
@@ -10,31 +14,77 @@ namespace atf
 class exhaustive : public search_technique_1d
 {
   public:
-    big_int _search_space_size;
+    big_int            _search_space_size;
+    bool               _native = false;
+    unsigned long long _search_space_size_64 = 0;
+    unsigned long long _pos_64 = 0;
+    big_int            _pos = 0;
+    size_t             _batch_size = 1;
 
     void initialize(big_int search_space_size) override
     {
       _search_space_size = search_space_size;
+
+      // positions in search spaces whose size fits into 64 bits are counted natively
+      _native = search_space_size <= big_int( static_cast<unsigned long long>( ULLONG_MAX ) );
+      if( _native )
+        _search_space_size_64 = static_cast<unsigned long long>( search_space_size );
     }
   
   
+    // the next "_batch_size" indices (at most the whole search space)
     std::set<index> get_next_indices() override
     {
-      static big_int pos = 0;
-      
-      if( pos == _search_space_size )
-        pos = 0;
-      
-      return { pos++ };
+      std::set<index> indices;
+      if( _native )
+      {
+        for( size_t i = 0 ; i < _batch_size && i < _search_space_size_64 ; ++i )
+        {
+          if( _pos_64 == _search_space_size_64 )
+            _pos_64 = 0;
+
+          indices.emplace( big_int( _pos_64++ ) );
+        }
+        return indices;
+      }
+
+      for( size_t i = 0 ; i < _batch_size ; ++i )
+      {
+        if( _pos == _search_space_size )
+          _pos = 0;
+
+        indices.emplace( _pos++ );
+      }
+      return indices;
     }
   
     
-    void report_costs(const std::map<index, cost_t>& costs) override
+    void report_costs(const std::map<index, cost_t>& /* costs */) override
     {}
+
+
+    void set_batch_size( size_t batch_size ) override
+    {
+      _batch_size = std::max( batch_size, size_t( 1 ) );
+    }
   
   
     void finalize() override
     {}
+
+
+    void save_state( std::ostream& out ) const override
+    {
+      detail::save_value( out, _pos_64 );
+      detail::save_value( out, _pos );
+    }
+
+
+    void load_state( std::istream& in ) override
+    {
+      detail::load_value( in, _pos_64 );
+      detail::load_value( in, _pos );
+    }
 };
 
 } // namespace "atf"
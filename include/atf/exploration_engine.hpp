@@ -3,20 +3,39 @@
 #define exploration_engine_h
 
 #include <tuple>
-#ifdef PARALLEL_SEARCH_SPACE_GENERATION
+#include <deque>
+#include <exception>
 #include <thread>
-#endif
+#include <atomic>
 #include <utility>
 #include <chrono>
+#include <typeinfo>
+#include <cstdio>
+#include <iterator>
 
 #include "search_space_tree.hpp"
+#include "search_space_flat.hpp"
+#include "search_space_lazy.hpp"
+#include "search_space_dag.hpp"
 #include "abort_condition.hpp"
 #include "search_technique.hpp"
 #include "search_technique_1d.hpp"
+#include "exhaustive.hpp"
 #include "tuning_status.hpp"
+#include "isolation.hpp"
+#include "measurement.hpp"
+#include "objectives.hpp"
+#include "trace.hpp"
 
 #include "helper.hpp"
 #include "tp.hpp"
+#include "detail/worker_pool.hpp"
+#include "detail/bounded_queue.hpp"
+#include "detail/cost_function_stages.hpp"
+#include "detail/evaluation_cache.hpp"
+#include "detail/tuning_database.hpp"
+#include "detail/log_writer.hpp"
+#include "detail/columnar_log.hpp"
 
 
 namespace atf
@@ -48,6 +67,14 @@ auto G( TPs&... tps )
   return G_class<TPs...>( tps... );
 }
 
+// size of the search space of TPs, computed without generating the search space
+struct search_space_size
+{
+  big_int                num_configs; // product of the TP groups' numbers of configurations
+  std::vector< big_int > num_nodes;   // per TP (in order of the TPs): number of valid partial configurations up to this TP within its group
+};
+
+
 class tuner;
 
 class exploration_engine
@@ -56,7 +83,7 @@ public:
     friend atf::tuner;
 
     exploration_engine()
-      : _search_space(), _abort_on_error( false ), _status()
+      : _search_space(), _status(), _abort_on_error( false )
     {
       _abort_condition = NULL;
       _copy_abort_condition = []() -> abort_condition* { return NULL; };
@@ -73,36 +100,76 @@ public:
 
     exploration_engine(const exploration_engine& other )       :
       _search_space(other._search_space),
+      _status( other._status ),
       _abort_condition( other._copy_abort_condition() ),
       _copy_abort_condition( other._copy_abort_condition ),
-      _search_technique( other._copy_search_technique() ),
-      _copy_search_technique( other._copy_search_technique ),
-      _search_technique_1d( other._copy_search_technique_1d() ),
-      _copy_search_technique_1d( other._copy_search_technique_1d ),
       _abort_on_error( other._abort_on_error ),
       _silent( other._silent ),
+      _num_evaluation_threads( other._num_evaluation_threads ),
+      _pipelined( other._pipelined ),
+      _pipeline_queue_capacity( other._pipeline_queue_capacity ),
+      _result_cache( other._result_cache ),
+      _database(),
+      _database_path( other._database_path ),
+      _resume( other._resume ),
+      _checkpoint_path( other._checkpoint_path ),
+      _checkpoint_interval( other._checkpoint_interval ),
+      _objective_names( other._objective_names ),
+      _scalarization( other._scalarization ),
+      _log_file( other._log_file ),
+      _log_format( other._log_format ),
+      _columnar_log(),
+      _log_buffer_capacity( other._log_buffer_capacity ),
+      _log_flush_interval( other._log_flush_interval ),
+      _trace_file( other._trace_file ),
+      _search_space_file( other._search_space_file ),
+      _search_space_key( other._search_space_key ),
+      _split_independent_tps( other._split_independent_tps ),
 #ifdef PARALLEL_SEARCH_SPACE_GENERATION
       _threads(),
+      _thread_errors(),
 #endif
-      _status( other._status ),
-      _log_file( other._log_file )
+      _search_technique( other._copy_search_technique() ),
+      _copy_search_technique( other._copy_search_technique ),
+      _search_technique_1d( other._copy_search_technique_1d() ),
+      _copy_search_technique_1d( other._copy_search_technique_1d )
     {}
 
     exploration_engine(exploration_engine&& other )       :
       _search_space( other._search_space ),
+      _status( other._status ),
       _abort_condition( other._copy_abort_condition() ),
       _copy_abort_condition( other._copy_abort_condition ),
-      _search_technique( other._copy_search_technique() ),
-      _copy_search_technique( other._copy_search_technique ),
-      _search_technique_1d( other._copy_search_technique_1d() ),
-      _copy_search_technique_1d( other._copy_search_technique_1d ),
       _abort_on_error( other._abort_on_error ),
       _silent( other._silent ),
+      _num_evaluation_threads( other._num_evaluation_threads ),
+      _pipelined( other._pipelined ),
+      _pipeline_queue_capacity( other._pipeline_queue_capacity ),
+      _result_cache( other._result_cache ),
+      _database(),
+      _database_path( other._database_path ),
+      _resume( other._resume ),
+      _checkpoint_path( other._checkpoint_path ),
+      _checkpoint_interval( other._checkpoint_interval ),
+      _objective_names( other._objective_names ),
+      _scalarization( other._scalarization ),
+      _log_file( other._log_file ),
+      _log_format( other._log_format ),
+      _columnar_log(),
+      _log_buffer_capacity( other._log_buffer_capacity ),
+      _log_flush_interval( other._log_flush_interval ),
+      _trace_file( other._trace_file ),
+      _search_space_file( other._search_space_file ),
+      _search_space_key( other._search_space_key ),
+      _split_independent_tps( other._split_independent_tps ),
 #ifdef PARALLEL_SEARCH_SPACE_GENERATION
       _threads(),
+      _thread_errors(),
 #endif
-      _status( other._status ),
-      _log_file( other._log_file )
+      _search_technique( other._copy_search_technique() ),
+      _copy_search_technique( other._copy_search_technique ),
+      _search_technique_1d( other._copy_search_technique_1d() ),
+      _copy_search_technique_1d( other._copy_search_technique_1d )
     {}
 
   
@@ -135,8 +202,82 @@ public:
       _silent = silent;
     }
 
-    void set_log_file(const std::string &log_file) {
-      _log_file = log_file;
+    // ungrouped TPs passed to "operator()" are generated as separate trees per group of TPs whose predicates read each other;
+    // "false": as one tree, in the order of the TPs
+    void set_split_independent_tps(bool split) {
+      _split_independent_tps = split;
+    }
+
+    // number of threads that evaluate the configurations requested by the search technique concurrently; 1: sequential evaluation
+    void set_num_evaluation_threads(size_t num_threads) {
+      _num_evaluation_threads = std::max( num_threads, static_cast<size_t>( 1 ) );
+    }
+
+    // evaluates configurations in a pipeline of stages that run concurrently: the configurations requested by the search technique are
+    // decoded, compiled (if the cost function has a compile stage, see "detail::has_compile_stage"), and measured one at a time
+    void set_pipelined(bool pipelined, size_t queue_capacity) {
+      _pipelined               = pipelined;
+      _pipeline_queue_capacity = std::max( queue_capacity, static_cast<size_t>( 1 ) );
+    }
+
+    // number of configurations requested from the search technique per call: one per evaluation thread, or as many as the
+    // pipeline holds (both queues, and one configuration in each of the compile and measure stages)
+    size_t batch_size() const {
+      return _pipelined ? 2 * _pipeline_queue_capacity + 2 : _num_evaluation_threads;
+    }
+
+    // results are cached by the configurations' canonical indices, such that configurations requested again are not evaluated again;
+    // a cache with a capacity evicts the least recently used results, capacity "0": unbounded
+    void set_result_cache(bool enabled, size_t capacity) {
+      _result_cache.configure( enabled, capacity );
+    }
+
+    // every evaluation is appended to the tuning database at this path; if "resume", the evaluations of a previous run recorded
+    // in the database are restored before tuning continues
+    void set_database(const std::string &path, bool resume) {
+      _database_path = path;
+      _resume        = resume;
+    }
+
+    // the search technique's state is saved to this file every "interval" evaluations (between requests of the technique), and
+    // loaded from it when a run is resumed from its tuning database
+    void set_checkpoint(const std::string &path, size_t interval) {
+      _checkpoint_path     = path;
+      _checkpoint_interval = std::max( interval, static_cast<size_t>( 1 ) );
+    }
+
+    // the cost function returns an objective vector with an entry per name; the vectors are tracked in the tuning status' Pareto
+    // front and logged, while the search technique minimizes their scalarization (and receives the vectors via "report_objectives")
+    void set_objectives(const std::vector<std::string> &names, const atf::scalarization &scalarization) {
+      if (names.empty())
+        throw std::runtime_error("at least one objective is required");
+      _objective_names = names;
+      _scalarization   = scalarization;
+    }
+
+    void set_log_file(const std::string &log_file, log_format format = log_format::csv) {
+      _log_file   = log_file;
+      _log_format = format;
+    }
+
+    // rows of the log file are written by a background thread: every "flush_interval", or once half of the buffer of "capacity"
+    // bytes is filled
+    void set_log_buffer(size_t capacity, std::chrono::milliseconds flush_interval) {
+      _log_buffer_capacity = capacity;
+      _log_flush_interval  = flush_interval;
+    }
+
+    // spans of the tuning phases (search technique, cost function, logging) are recorded during tuning and written to this file
+    // as Chrome trace JSON (see "trace.hpp")
+    void set_trace_file(const std::string &trace_file) {
+      _trace_file = trace_file;
+    }
+
+    // search space is loaded from this file if it has been generated for the same TPs before, and saved to it otherwise;
+    // "key" identifies state of the predicates that is not hashed automatically (e.g., values captured by lambdas)
+    void set_search_space_file(const std::string &search_space_file, const std::string &key = "") {
+      _search_space_file = search_space_file;
+      _search_space_key  = key;
     }
 
     // set tuning parameters
@@ -153,13 +294,40 @@ public:
     exploration_engine& operator()(G_class<Ts...> G_class, G_CLASSES... G_classes );
 
     template< typename callable >
-    tuning_status operator()( callable& program ); // program must take config_t and return a size_t
+    tuning_status operator()( callable& program ); // program must take a "configuration" or a "flat_configuration" and return a cost
+
+    // counts the configurations of TPs without generating their search space (the first TP of each group is split among threads)
+    template< typename... Ts, typename... range_ts, typename... callables >
+    search_space_size count_configs( tp_t<Ts,range_ts,callables>&... tps );
+
+    template< typename... Ts, typename... G_CLASSES >
+    search_space_size count_configs( G_class<Ts...> G_class, G_CLASSES... G_classes );
 
   protected:
-    search_space_tree _search_space;
+#if defined(LAZY_SEARCH_SPACE)
+    using search_space_t = search_space_lazy;
+#elif defined(COMPRESSED_SEARCH_SPACE)
+    using search_space_t = search_space_dag;
+#elif defined(FLAT_SEARCH_SPACE)
+    using search_space_t = search_space_flat;
+#else
+    using search_space_t = search_space_tree;
+#endif
+
+    search_space_t    _search_space;
     tuning_status     _status;
 
   private:
+    // cost function that returns an objective vector: tuned for the scalarization of its vectors
+    template< typename callable >
+    tuning_status tune( callable& program, std::true_type );
+
+    template< typename callable >
+    tuning_status tune( callable& program, std::false_type );
+
+    template< typename callable >
+    tuning_status tune( callable& program );
+
     template< typename... Ts, typename... rest_tp_tuples >
     void insert_tp_names_in_search_space( G_class<Ts...> tp_tuple, rest_tp_tuples... tuples );
 
@@ -175,6 +343,96 @@ public:
     void insert_tp_names_of_one_tree_in_search_space()
     {}
   
+    template< typename callable, typename... Ts, typename... rest_tp_tuples >
+    void for_each_tp( callable& f, G_class<Ts...> tp_tuple, rest_tp_tuples... tuples );
+
+    template< typename callable >
+    void for_each_tp( callable& )
+    {}
+
+    template< typename callable, typename... Ts, size_t... Is >
+    void for_each_tp_of_one_tree( callable& f, G_class<Ts...> tp_tuple, std::index_sequence<Is...> );
+
+    // partitions TPs into groups whose predicates do not (transitively) read TPs of other groups
+    template< typename... Ts, typename... range_ts, typename... callables >
+    std::vector< std::vector<size_t> > independent_tp_groups( tp_t<Ts,range_ts,callables>&... tps );
+
+    template< typename... Ts, typename... range_ts, typename... callables >
+    exploration_engine& generate_tp_groups( const std::vector< std::vector<size_t> >& groups, tp_t<Ts,range_ts,callables>&... tps );
+
+#ifndef LAZY_SEARCH_SPACE
+    // TP of a group determined at runtime; its type is erased, such that the trees of the groups are generated by
+    // "generate_config_tree" like the trees of "G(...)"
+    struct group_tp
+    {
+      using type = value_type;
+
+      struct act_elem_t
+      {
+        void*                         value;
+        std::function<void( size_t )> set_num_workers;
+
+        void* value_ptr() const
+        {
+          return value;
+        }
+      };
+
+      std::function<bool( value_type& )> next_value;
+      std::shared_ptr<act_elem_t>        _act_elem;
+
+      bool get_next_value( value_type& value )
+      {
+        return next_value( value );
+      }
+    };
+
+    template< typename T, typename range_t, typename callable >
+    static group_tp make_group_tp( tp_t<T,range_t,callable>& tp );
+
+    template< size_t TREE_DEPTH, std::enable_if_t<( TREE_DEPTH>0 )>* = nullptr >
+    void generate_tree_of_tp_group( size_t tree_id, std::vector<group_tp>& tps );
+
+    template< size_t TREE_DEPTH, std::enable_if_t<( TREE_DEPTH==0 )>* = nullptr >
+    void generate_tree_of_tp_group( size_t, std::vector<group_tp>& )
+    {}
+
+    template< size_t... Is >
+    void generate_tree_of_tp_group( size_t tree_id, std::vector<group_tp>& tps, std::index_sequence<Is...> );
+#endif
+
+    template< typename... Ts, typename... rest_tp_tuples >
+    void count_configs_of_groups( search_space_size& size, G_class<Ts...> tp_tuple, rest_tp_tuples... tuples );
+
+    void count_configs_of_groups( search_space_size& )
+    {}
+
+    template< typename... Ts, size_t... Is >
+    void count_configs_of_one_group( search_space_size& size, G_class<Ts...> tp_tuple, std::index_sequence<Is...> );
+
+    template< typename T, typename range_t, typename callable, typename... Ts >
+    big_int count_configs_in_parallel( std::vector<size_t>& num_nodes, tp_t<T,range_t,callable>& tp, Ts&... tps );
+
+    template< typename T, typename range_t, typename callable, typename... Ts >
+    size_t count_configs_of_subtrees( size_t* num_nodes, tp_t<T,range_t,callable>& tp, Ts&... tps );
+
+    size_t count_configs_of_subtrees( size_t* )
+    {
+      return 1;
+    }
+
+#ifdef LAZY_SEARCH_SPACE
+    template< typename... Ts, typename... rest_tp_tuples >
+    void add_tps_to_lazy_trees( size_t tree_id, G_class<Ts...> tp_tuple, rest_tp_tuples... tuples );
+
+    void add_tps_to_lazy_trees( size_t )
+    {}
+#endif
+
+    template< typename... G_CLASSES >
+    std::uint64_t search_space_key( G_CLASSES... G_classes );
+
+#ifndef LAZY_SEARCH_SPACE
     template< size_t TREE_ID, typename... Ts, typename... rest_tp_tuples>
     exploration_engine& generate_config_trees(G_class<Ts...> tp_tuple, rest_tp_tuples... tuples );
 
@@ -184,11 +442,89 @@ public:
     template< size_t TREE_ID >
     exploration_engine& generate_config_trees();
 
-    template< size_t TREE_ID, size_t TREE_DEPTH, typename T, typename range_t, typename callable, typename... Ts, std::enable_if_t<( TREE_DEPTH>0 )>* = nullptr >
-    void generate_single_config_tree( tp_t<T,range_t,callable>& tp, Ts&... tps );
+#ifdef PARALLEL_SEARCH_SPACE_GENERATION
+    template< typename callable >
+    void start_generation_thread( callable generate );
+#endif
+
+    template< size_t TREE_DEPTH, typename... Ts >
+    void generate_config_tree( size_t tree_id, Ts&... tps );
+
+    template< size_t TREE_DEPTH, typename TP, typename... Ts, std::enable_if_t<( TREE_DEPTH>0 )>* = nullptr >
+    void generate_single_config_tree( size_t tree_id, TP& tp, Ts&... tps );
   
-    template< size_t TREE_ID, size_t TREE_DEPTH, typename... Ts, std::enable_if_t<( TREE_DEPTH==0 )>* = nullptr >
-    void generate_single_config_tree( const Ts&... values );
+    template< size_t TREE_DEPTH, typename... Ts, std::enable_if_t<( TREE_DEPTH==0 )>* = nullptr >
+    void generate_single_config_tree( size_t tree_id, const Ts&... values );
+
+#ifdef PARALLEL_SEARCH_SPACE_GENERATION_SPLIT_DEPTH
+    // state of a worker that generates the subtrees below the paths (prefixes) of the first "split_depth" TPs it has claimed
+    struct subtree_generation_state
+    {
+      size_t                                                      split_depth;
+      std::atomic<size_t>&                                        next_prefix;
+      size_t                                                      claimed_prefix;
+      size_t                                                      num_visited_prefixes;
+      std::vector< std::pair<size_t, search_space_t::tree_type> >& subtrees;
+    };
+
+    template< size_t TREE_DEPTH, typename... Ts >
+    void generate_single_config_tree_in_parallel( size_t tree_id, Ts&... tps );
+
+    template< size_t TREE_DEPTH, size_t REMAINING_DEPTH, typename TP, typename... Ts, std::enable_if_t<( REMAINING_DEPTH>0 )>* = nullptr >
+    void generate_config_subtrees( subtree_generation_state& state, TP& tp, Ts&... tps );
+
+    template< size_t TREE_DEPTH, size_t REMAINING_DEPTH, typename... Ts, std::enable_if_t<( REMAINING_DEPTH==0 )>* = nullptr >
+    void generate_config_subtrees( subtree_generation_state& state, const Ts&... values );
+#endif
+#endif
+
+    // results of the configurations of a request of the search technique that are evaluated in parallel or pipelined
+    struct request_results
+    {
+      static constexpr size_t cached    = std::numeric_limits<size_t>::max();
+      static constexpr char   timed_out = 2;
+
+      std::vector< flat_configuration > configs;
+      std::vector< big_int >            cache_keys;
+      std::vector< size_t >             reused;             // per configuration: its own position if evaluated, "cached", or the position of an equal configuration
+      std::vector< char >               replayed;           // per configuration: cached result restored from a tuning database (see "restore_records")
+      std::vector< size_t >             to_evaluate;        // positions of the configurations to evaluate
+      std::vector< cost_t >             costs;
+      std::vector< double >             cost_variances;     // per configuration: variance of the measured cost (NaN: unknown)
+      std::vector< objective_vector >   objectives;         // per configuration: objective vector (empty: unknown or no objectives)
+      std::vector< char >               failed;             // per configuration: "0", "1", or "timed_out"
+      std::vector< size_t >             get_next_config_ms;
+      std::vector< size_t >             cost_function_ms;
+    };
+
+    template< typename callable >
+    void evaluate_sequentially( callable& program, detail::log_writer& csv_file, bool& write_header );
+
+    template< typename callable >
+    void evaluate_in_parallel( callable& program, detail::log_writer& csv_file, bool& write_header );
+
+    template< typename callable >
+    void evaluate_pipelined( callable& program, detail::log_writer& csv_file, bool& write_header );
+
+    void record_request_result( request_results& request, size_t i, detail::log_writer& csv_file, bool& write_header );
+
+    void restore_records( const std::vector< detail::tuning_record >& records, size_t num_checkpointed_records );
+
+    size_t read_checkpoint( std::string& technique_state );
+
+    void save_checkpoint_if_due( bool force = false );
+
+    void save_technique_state( std::ostream& out ) const;
+
+    void append_to_database( const big_int& canonical, cost_t cost, bool failed, bool timed_out, bool cache_hit, const objective_vector& objectives );
+
+    static bool is_timeout( std::exception_ptr exception );
+
+    std::uint64_t search_space_id() const;
+
+    void record_result( const configuration& config, cost_t program_runtime, double cost_variance, const objective_vector& objectives, size_t get_next_config_ms, size_t cost_function_ms, detail::log_writer& csv_file, bool& write_header );
+
+    void append_to_columnar_log( const configuration& config, cost_t program_runtime, double cost_variance, const objective_vector& objectives, size_t get_next_config_ms, size_t cost_function_ms, size_t report_cost_ms, bool& write_header );
 
     template< typename T, typename... Ts >
     void print_path(T val, Ts... tps);
@@ -202,24 +538,55 @@ public:
     std::function<abort_condition*()> _copy_abort_condition;
     const bool                                  _abort_on_error;
     bool                                        _silent = false;
+    size_t                                      _num_evaluation_threads = 1;
+    bool                                        _pipelined = false;
+    size_t                                      _pipeline_queue_capacity = 2;
+    detail::evaluation_cache                    _result_cache;
+    detail::tuning_database                     _database;
+    std::string                                 _database_path;
+    bool                                        _resume = false;
+    std::string                                 _checkpoint_path;
+    size_t                                      _checkpoint_interval = 100;
+    size_t                                      _evaluations_at_checkpoint = 0;
+    std::vector<std::string>                    _objective_names;
+    atf::scalarization                          _scalarization;
     std::string                                 _log_file;
+    log_format                                  _log_format = log_format::csv;
+    detail::columnar_log_writer                 _columnar_log;
+    size_t                                      _log_buffer_capacity = 1 << 20;
+    std::chrono::milliseconds                   _log_flush_interval{ 100 };
+    std::string                                 _trace_file;
+    std::string                                 _search_space_file;
+    std::string                                 _search_space_key;
+    bool                                        _split_independent_tps = true;
 #ifdef PARALLEL_SEARCH_SPACE_GENERATION
     std::vector<std::thread>                     _threads;
+    std::deque<std::exception_ptr>               _thread_errors; // a deque, such that threads keep references to their entries
 #endif
     std::unique_ptr<search_technique>     _search_technique;
     std::function<search_technique*()>    _copy_search_technique;
     std::set<coordinates>                 _next_coordinates{};
     std::map<coordinates, cost_t>         _next_costs{};
+    std::map<coordinates, objective_vector> _next_objectives{};
     std::unique_ptr<search_technique_1d>  _search_technique_1d;
     std::function<search_technique_1d*()> _copy_search_technique_1d;
     std::set<index>                       _next_indices_1d{};
     std::map<index, cost_t>               _next_costs_1d{};
+    std::map<index, objective_vector>     _next_objectives_1d{};
+    flat_configuration                    _config_buffer;
 
     void initialize() {
+#ifdef LAZY_SEARCH_SPACE
+      // exhaustive search would enumerate the upper bound of the number of configurations, visiting configurations repeatedly
+      if (dynamic_cast<exhaustive*>(_search_technique_1d.get()) != nullptr)
+        throw std::runtime_error("exhaustive search is not supported by LAZY_SEARCH_SPACE");
+#endif
       if (_search_technique) {
         _search_technique->initialize( _search_space.num_params() );
+        _search_technique->set_batch_size( batch_size() );
       } else if (_search_technique_1d) {
         _search_technique_1d->initialize( _search_space.num_configs() );
+        _search_technique_1d->set_batch_size( batch_size() );
       }
     }
 
@@ -231,33 +598,145 @@ public:
       }
     }
 
-    configuration get_next_config() {
+    // decodes the next configuration into "_config_buffer", reusing its buffers
+    flat_configuration& get_next_config() {
       if (_search_technique) {
-        if (_next_coordinates.empty())
+        if (_next_coordinates.empty()) {
+          trace_span span( "get_next_coordinates", "search technique" );
           _next_coordinates = _search_technique->get_next_coordinates();
-        return _search_space.get_configuration( *_next_coordinates.begin() );
+        }
+        trace_span span( "decode configuration", "search space" );
+        _search_space.get_configuration( *_next_coordinates.begin(), _config_buffer );
+        return _config_buffer;
       } else if (_search_technique_1d) {
-        if (_next_indices_1d.empty())
+        if (_next_indices_1d.empty()) {
+          trace_span span( "get_next_indices", "search technique" );
           _next_indices_1d = _search_technique_1d->get_next_indices();
-        return _search_space.get_configuration( *_next_indices_1d.begin() );
+        }
+        trace_span span( "decode configuration", "search space" );
+        _search_space.get_configuration( *_next_indices_1d.begin(), _config_buffer );
+        return _config_buffer;
       }
       throw std::runtime_error("no search technique selected");
     }
 
-    void report_result(cost_t cost) {
+    // decodes all pending configurations of the search technique, each into its own buffer, and looks their results up in the
+    // result cache; returns their number
+    size_t get_next_configs( request_results& request ) {
+      auto decode = [&]( const auto& points ) {
+        const size_t num_configs = points.size();
+        if( request.configs.size() < num_configs )
+          request.configs.resize( num_configs );
+        request.cache_keys.resize( needs_canonical_index() ? num_configs : 0 );
+        request.reused.resize( num_configs );
+        request.replayed.resize( num_configs );
+        request.to_evaluate.clear();
+        request.costs.resize( num_configs );
+        request.cost_variances.assign( num_configs, std::numeric_limits<double>::quiet_NaN() );
+        request.objectives.assign( num_configs, objective_vector() );
+        request.failed.resize( num_configs );
+        request.get_next_config_ms.resize( num_configs );
+        request.cost_function_ms.resize( num_configs );
+
+        size_t i = 0;
+        for( const auto& point : points ) {
+          auto get_next_config_start = std::chrono::steady_clock::now();
+          {
+            trace_span span( "decode configuration", "search space" );
+            _search_space.get_configuration( point, request.configs[ i ] );
+          }
+          auto get_next_config_end = std::chrono::steady_clock::now();
+          request.get_next_config_ms[ i ] = std::chrono::duration_cast<std::chrono::milliseconds>(get_next_config_end - get_next_config_start).count();
+
+          request.reused[ i ]   = i;
+          request.replayed[ i ] = false;
+          if( needs_canonical_index() )
+            request.cache_keys[ i ] = canonical_index( point );
+          if( _result_cache.enabled() ) {
+            detail::evaluation_cache::result cached_result;
+            if( _result_cache.find( request.cache_keys[ i ], cached_result ) ) {
+              request.reused[ i ]   = request_results::cached;
+              request.replayed[ i ] = cached_result.replayed;
+              request.costs[ i ]    = cached_result.cost;
+              request.failed[ i ]   = cached_result.failed;
+              request.objectives[ i ] = cached_result.objectives;
+            } else {
+              for( size_t j = 0 ; j < i ; ++j )
+                if( request.reused[ j ] == j && request.cache_keys[ j ] == request.cache_keys[ i ] )
+                  request.reused[ i ] = j;
+            }
+          }
+          if( request.reused[ i ] == i )
+            request.to_evaluate.emplace_back( i );
+          ++i;
+        }
+        return num_configs;
+      };
+
+      if (_search_technique) {
+        if (_next_coordinates.empty()) {
+          trace_span span( "get_next_coordinates", "search technique" );
+          _next_coordinates = _search_technique->get_next_coordinates();
+        }
+        return decode( _next_coordinates );
+      } else if (_search_technique_1d) {
+        if (_next_indices_1d.empty()) {
+          trace_span span( "get_next_indices", "search technique" );
+          _next_indices_1d = _search_technique_1d->get_next_indices();
+        }
+        return decode( _next_indices_1d );
+      }
+      throw std::runtime_error("no search technique selected");
+    }
+
+    // canonical indices key the result cache and the records of the tuning database
+    bool needs_canonical_index() const {
+      return _result_cache.enabled() || _database.is_open();
+    }
+
+    // canonical index of a point of the search technique: the key of its configuration's result in the result cache
+    big_int canonical_index( const coordinates& point ) const {
+      return _search_space.index_of( point );
+    }
+
+    big_int canonical_index( const index& point ) const {
+      return point;
+    }
+
+    // canonical index of the configuration decoded by "get_next_config"
+    big_int next_canonical_index() const {
+      if (_search_technique)
+        return canonical_index( *_next_coordinates.begin() );
+      return canonical_index( *_next_indices_1d.begin() );
+    }
+
+    // objectives (if any) are reported to the search technique right before the costs of its request
+    void report_result(cost_t cost, const objective_vector& objectives = {}) {
       if (_search_technique) {
         _next_costs[ *_next_coordinates.begin() ] = cost;
+        if (!objectives.empty())
+          _next_objectives[ *_next_coordinates.begin() ] = objectives;
         _next_coordinates.erase( _next_coordinates.begin() );
         if (_next_coordinates.empty()) {
+          trace_span span( "report_costs", "search technique" );
+          if (!_objective_names.empty())
+            _search_technique->report_objectives( _next_objectives );
           _search_technique->report_costs( _next_costs );
           _next_costs.clear();
+          _next_objectives.clear();
         }
       } else if (_search_technique_1d) {
         _next_costs_1d[ *_next_indices_1d.begin() ] = cost;
+        if (!objectives.empty())
+          _next_objectives_1d[ *_next_indices_1d.begin() ] = objectives;
         _next_indices_1d.erase( _next_indices_1d.begin() );
         if (_next_indices_1d.empty()) {
+          trace_span span( "report_costs", "search technique" );
+          if (!_objective_names.empty())
+            _search_technique_1d->report_objectives( _next_objectives_1d );
           _search_technique_1d->report_costs( _next_costs_1d );
           _next_costs_1d.clear();
+          _next_objectives_1d.clear();
         }
       }
     }
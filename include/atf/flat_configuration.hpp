@@ -0,0 +1,194 @@
+#ifndef flat_configuration_h
+#define flat_configuration_h
+
+#include <vector>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <stdexcept>
+#include <assert.h>
+
+#include "tp.hpp"
+#include "tp_value.hpp"
+
+namespace atf
+{
+
+// Configuration whose TP values are stored by position (the TP's position in the search space); the TP names are
+// not copied but refer to the names interned in the search space. Decoding into an existing "flat_configuration"
+// reuses its buffers, such that steady-state decoding performs no heap allocations.
+// Values are accessed by TP, e.g. "config[ WPT ]", by position, or by name.
+class flat_configuration
+{
+  public:
+    flat_configuration()
+      : _names( nullptr ), _values(), _config(), _config_entries()
+    {}
+
+    // copies do not share the string-keyed view
+    flat_configuration( const flat_configuration& other )
+      : _names( other._names ), _values( other._values ), _config(), _config_entries()
+    {}
+
+    flat_configuration( flat_configuration&& other ) = default;
+
+    flat_configuration& operator=( const flat_configuration& other )
+    {
+      if( &other != this )
+      {
+        _names  = other._names;
+        _values = other._values;
+        _config.clear();
+        _config_entries.clear();
+      }
+      return *this;
+    }
+
+    flat_configuration& operator=( flat_configuration&& other ) = default;
+
+
+    // binds the configuration to the TP names of a search space; called by the search spaces before decoding
+    void reset( const std::vector<std::string>& names )
+    {
+      if( _names != &names || _values.size() != names.size() )
+      {
+        _names = &names;
+        _values.resize( names.size() );
+        _config.clear();
+        _config_entries.clear();
+      }
+    }
+
+
+    size_t size() const
+    {
+      return _values.size();
+    }
+
+
+    const std::string& name( size_t pos ) const
+    {
+      return ( *_names )[ pos ];
+    }
+
+
+    tp_value& operator[]( size_t pos )
+    {
+      return _values[ pos ];
+    }
+
+
+    const tp_value& operator[]( size_t pos ) const
+    {
+      return _values[ pos ];
+    }
+
+
+    // typed access by TP handle: the TP's value with its native type, without name lookup and type switch
+    template< typename T, typename range_t, typename callable >
+    const T& operator[]( const tp_t<T,range_t,callable>& tp ) const
+    {
+      assert( tp.position() < _values.size() && name( tp.position() ) == tp.name() );
+      return _values[ tp.position() ].value().template native<T>();
+    }
+
+
+    const tp_value& operator[]( const std::string& name ) const
+    {
+      for( size_t pos = 0 ; pos < _values.size() ; ++pos )
+        if( this->name( pos ) == name )
+          return _values[ pos ];
+
+      throw std::runtime_error( "unknown tuning parameter: " + name );
+    }
+
+
+    void set( size_t pos, const value_type& value, void* tp_value_ptr )
+    {
+      _values[ pos ].assign( value, tp_value_ptr );
+    }
+
+
+    // sets the TPs to the configuration's values
+    void update_tps() const
+    {
+      for( const auto& value : _values )
+        value.update_tp();
+    }
+
+
+    // string-keyed view of the configuration for cost functions; the view's entries are created once and afterwards
+    // updated in place
+    configuration& as_configuration()
+    {
+      if( _config_entries.size() != _values.size() )
+      {
+        _config.clear();
+        _config_entries.clear();
+        for( size_t pos = 0 ; pos < _values.size() ; ++pos )
+          _config_entries.emplace_back( &_config.emplace( name( pos ), _values[ pos ] ).first->second );
+      }
+      else
+      {
+        for( size_t pos = 0 ; pos < _values.size() ; ++pos )
+          *_config_entries[ pos ] = _values[ pos ];
+      }
+
+      return _config;
+    }
+
+
+    configuration to_configuration() const
+    {
+      configuration config;
+      for( size_t pos = 0 ; pos < _values.size() ; ++pos )
+        config.emplace( name( pos ), _values[ pos ] );
+
+      return config;
+    }
+
+  private:
+    const std::vector< std::string >* _names;
+    std::vector< tp_value >           _values;
+    configuration                     _config;
+    std::vector< tp_value* >          _config_entries; // entry of "_config" per position
+};
+
+
+namespace detail
+{
+
+// stores the decoded value of the TP at position "pos" in a configuration
+inline void store_tp_value( configuration& config, const std::vector<std::string>& names, size_t pos, const value_type& value, void* tp_value_ptr )
+{
+  config.emplace( std::piecewise_construct,
+                  std::forward_as_tuple( names[ pos ]          ),
+                  std::forward_as_tuple( value, tp_value_ptr )
+                );
+}
+
+inline void store_tp_value( flat_configuration& config, const std::vector<std::string>&, size_t pos, const value_type& value, void* tp_value_ptr )
+{
+  config.set( pos, value, tp_value_ptr );
+}
+
+
+// calls a cost function with the string-keyed view "config" of "flat_config", or with "flat_config" if the cost function
+// only takes a "flat_configuration"
+template< typename callable >
+auto call_cost_function( callable& cf, flat_configuration&, configuration& config, int ) -> decltype( cf( config ) )
+{
+  return cf( config );
+}
+
+template< typename callable >
+auto call_cost_function( callable& cf, flat_configuration& flat_config, configuration&, long ) -> decltype( cf( flat_config ) )
+{
+  return cf( flat_config );
+}
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* flat_configuration_h */
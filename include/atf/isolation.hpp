@@ -0,0 +1,149 @@
+#ifndef isolation_h
+#define isolation_h
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+#include "tp_value.hpp"
+#include "tuning_status.hpp"
+#include "trace.hpp"
+#include "detail/process.hpp"
+
+namespace atf
+{
+
+// thrown by cost functions whose evaluation exceeded its time limit; counted as an invalid configuration and as a timeout
+class evaluation_timeout : public std::runtime_error
+{
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+
+// Wall-clock time limit of an evaluation: fixed, or relative to the duration of the evaluation with the best cost found so far.
+// Copies share the best evaluation, such that all copies of a cost function use the same limit.
+class timeout_class
+{
+  public:
+    timeout_class( double fixed_ms, double factor, double min_ms, double max_ms )
+      : _fixed_ms( fixed_ms ), _factor( factor ), _min_ms( min_ms ), _max_ms( max_ms ), _best( std::make_shared<best_evaluation>() )
+    {}
+
+    // current limit in milliseconds (infinity: no limit)
+    double limit_ms() const
+    {
+      if( _factor == 0.0 )
+        return _fixed_ms;
+
+      std::lock_guard<std::mutex> lock( _best->mutex );
+      if( _best->cost == std::numeric_limits<cost_t>::max() )
+        return _max_ms;
+      return std::min( std::max( _factor * _best->duration_ms, _min_ms ), _max_ms );
+    }
+
+    // reports the cost and duration of a successful evaluation
+    void report( cost_t cost, double duration_ms ) const
+    {
+      std::lock_guard<std::mutex> lock( _best->mutex );
+      if( cost < _best->cost )
+      {
+        _best->cost        = cost;
+        _best->duration_ms = duration_ms;
+      }
+    }
+
+  private:
+    struct best_evaluation
+    {
+      std::mutex mutex;
+      cost_t     cost        = std::numeric_limits<cost_t>::max();
+      double     duration_ms = 0.0;
+    };
+
+    double                             _fixed_ms;
+    double                             _factor;
+    double                             _min_ms;
+    double                             _max_ms;
+    std::shared_ptr<best_evaluation>   _best;
+};
+
+// fixed limit of "ms" milliseconds; infinity: no limit
+inline timeout_class timeout( double ms = std::numeric_limits<double>::infinity() )
+{
+  return timeout_class( ms, 0.0, 0.0, ms );
+}
+
+// limit of "factor" times the duration of the evaluation with the best cost found so far, within [min_ms, max_ms]; until an
+// evaluation has succeeded, the limit is "max_ms"
+inline timeout_class relative_timeout( double factor, double min_ms, double max_ms = std::numeric_limits<double>::infinity() )
+{
+  if( factor <= 0.0 )
+    throw std::runtime_error( "factor of a relative timeout must be positive" );
+  return timeout_class( max_ms, factor, min_ms, max_ms );
+}
+
+
+namespace detail
+{
+
+// Runs "command" in its own process group, which is killed once the time limit is exceeded; returns the command's exit code
+// (or throws "evaluation_timeout"). If the command is killed after "race_limit_ms" (see "racing") instead, "stopped" is set
+// and 0 is returned.
+inline int run_command_with_timeout( const std::string& command, const timeout_class& timeout, double race_limit_ms, bool& stopped )
+{
+  const double limit_ms = timeout.limit_ms();
+  const auto   result   = run_command( command, std::min( limit_ms, race_limit_ms ) );
+  stopped = result.timed_out && race_limit_ms < limit_ms;
+  if( stopped )
+    return 0;
+  if( result.timed_out )
+    throw evaluation_timeout( "evaluation exceeded its time limit of " + std::to_string( limit_ms ) + "ms" );
+
+  return result.exited ? result.exit_code : -1;
+}
+
+inline int run_command_with_timeout( const std::string& command, const timeout_class& timeout )
+{
+  bool stopped;
+  return run_command_with_timeout( command, timeout, std::numeric_limits<double>::infinity(), stopped );
+}
+
+} // namespace "detail"
+
+
+// Evaluates "cost_function" in a forked child process: a configuration that crashes the cost function (e.g., a segmentation fault
+// in an "atf::cpp" tunable) or exceeds the time limit is counted as invalid instead of taking the tuner down. On expiry of the
+// limit, the child's process group (i.e., also the processes it started) is killed.
+template< typename callable >
+auto isolated( callable cost_function, const timeout_class& timeout = atf::timeout() )
+{
+  return [ cost_function, timeout ]( configuration& config ) mutable -> cost_t {
+    trace_span span( "isolated evaluation", "isolation" );
+    const double limit_ms = timeout.limit_ms();
+    const auto   start    = std::chrono::steady_clock::now();
+
+    // tracing is stopped in the child: its spans would be lost with it (and its copy of the tracer's locks may be held)
+    cost_t cost;
+    const auto result = detail::run_in_child_process( [ & ]() { detail::tracer::instance().stop(); return static_cast<double>( cost_function( config ) ); }, limit_ms, cost );
+    const auto end    = std::chrono::steady_clock::now();
+
+    if( result.timed_out )
+      throw evaluation_timeout( "evaluation exceeded its time limit of " + std::to_string( limit_ms ) + "ms" );
+    if( !result.exited )
+      throw std::runtime_error( "evaluation process crashed" );
+    if( result.exit_code != EXIT_SUCCESS )
+      throw std::runtime_error( "evaluation failed" );
+
+    timeout.report( cost, std::chrono::duration<double, std::milli>( end - start ).count() );
+    return cost;
+  };
+}
+
+} // namespace "atf"
+
+#endif /* isolation_h */
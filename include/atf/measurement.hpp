@@ -0,0 +1,279 @@
+#ifndef measurement_h
+#define measurement_h
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "tp_value.hpp"
+#include "tuning_status.hpp"
+#include "racing.hpp"
+#include "trace.hpp"
+
+namespace atf
+{
+
+namespace detail
+{
+
+// if set, a measurement on the calling thread stores the variance of its repetitions here; used to log the variance of costs
+inline double*& measurement_log()
+{
+  static thread_local double* log = nullptr;
+  return log;
+}
+
+
+// quantile of the standard normal distribution (Acklam's rational approximation; relative error below 1.2e-9)
+inline double normal_quantile( double p )
+{
+  static const double a[] = { -3.969683028665376e+01,  2.209460984245205e+02, -2.759285104469687e+02,  1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+  static const double b[] = { -5.447609879822406e+01,  1.615858368580409e+02, -1.556989798598866e+02,  6.680131188771972e+01, -1.328068155288572e+01 };
+  static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00,  4.374664141464968e+00, 2.938163982698783e+00 };
+  static const double d[] = {  7.784695709041462e-03,  3.224671290700398e-01,  2.445134137142996e+00,  3.754408661907416e+00 };
+
+  const double p_low = 0.02425;
+  if( p < p_low || p > 1 - p_low )
+  {
+    const double q = std::sqrt( -2 * std::log( std::min( p, 1 - p ) ) );
+    const double x = ( ( ( ( ( c[0] * q + c[1] ) * q + c[2] ) * q + c[3] ) * q + c[4] ) * q + c[5] ) / ( ( ( ( d[0] * q + d[1] ) * q + d[2] ) * q + d[3] ) * q + 1 );
+    return p < p_low ? x : -x;
+  }
+
+  const double q = p - 0.5;
+  const double r = q * q;
+  return ( ( ( ( ( a[0] * r + a[1] ) * r + a[2] ) * r + a[3] ) * r + a[4] ) * r + a[5] ) * q / ( ( ( ( ( b[0] * r + b[1] ) * r + b[2] ) * r + b[3] ) * r + b[4] ) * r + 1 );
+}
+
+
+// quantile of Student's t distribution with "dof" degrees of freedom: exact for 1 and 2 degrees of freedom, otherwise the
+// Cornish-Fisher expansion around the normal quantile
+inline double student_t_quantile( double p, size_t dof )
+{
+  if( dof == 1 )
+    return std::tan( std::acos( -1.0 ) * ( p - 0.5 ) );
+  if( dof == 2 )
+    return ( 2 * p - 1 ) / std::sqrt( 2 * p * ( 1 - p ) );
+
+  const double z  = normal_quantile( p );
+  const double z2 = z * z;
+  const double n  = static_cast<double>( dof );
+  const double g1 = ( z2 + 1 ) * z / 4;
+  const double g2 = ( ( 5 * z2 + 16 ) * z2 + 3 ) * z / 96;
+  const double g3 = ( ( ( 3 * z2 + 19 ) * z2 + 17 ) * z2 - 15 ) * z / 384;
+  const double g4 = ( ( ( ( 79 * z2 + 776 ) * z2 + 1482 ) * z2 - 1920 ) * z2 - 945 ) * z / 92160;
+  return z + ( g1 + ( g2 + ( g3 + g4 / n ) / n ) / n ) / n;
+}
+
+} // namespace "detail"
+
+
+enum class aggregation { mean, median, trimmed_mean, min };
+
+
+// Measurement policy: the cost of a configuration is measured by repeating a measurement (e.g., a kernel run) between a
+// minimum and a maximum number of times, until the confidence interval of the repetitions' mean is narrow enough relative to
+// the mean. Outliers can be rejected (Tukey's fences) before the remaining repetitions are aggregated to the cost.
+class measurement_class
+{
+  public:
+    measurement_class()
+      : _min_repetitions( 1 ), _max_repetitions( 1 ), _relative_width( 0.0 ), _confidence_level( 0.95 ), _aggregation( aggregation::mean ), _trim_fraction( 0.1 ), _outlier_factor( 0.0 )
+    {}
+
+    // without a confidence target, "min" repetitions are measured
+    measurement_class& repetitions( size_t min, size_t max )
+    {
+      if( min == 0 || max < min )
+        throw std::runtime_error( "invalid number of repetitions" );
+      _min_repetitions = min;
+      _max_repetitions = max;
+      return *this;
+    }
+
+    // repeats until the half width of the "level" confidence interval of the mean is at most "relative_width" times the mean
+    measurement_class& confidence( double relative_width, double level = 0.95 )
+    {
+      if( relative_width <= 0.0 || level <= 0.0 || level >= 1.0 )
+        throw std::runtime_error( "invalid confidence target" );
+      _relative_width   = relative_width;
+      _confidence_level = level;
+      return *this;
+    }
+
+    // "trim_fraction": fraction of the smallest and of the largest repetitions left out by "aggregation::trimmed_mean"
+    measurement_class& aggregate( atf::aggregation aggregation, double trim_fraction = 0.1 )
+    {
+      if( trim_fraction < 0.0 || trim_fraction >= 0.5 )
+        throw std::runtime_error( "trim fraction must be in [0, 0.5)" );
+      _aggregation   = aggregation;
+      _trim_fraction = trim_fraction;
+      return *this;
+    }
+
+    // Repetitions outside of [Q1 - factor * IQR, Q3 + factor * IQR] are left out of the confidence interval and the aggregation
+    // (factor 0: no rejection). Outliers are rejected from 4 repetitions on.
+    measurement_class& reject_outliers( double factor = 1.5 )
+    {
+      if( factor < 0.0 )
+        throw std::runtime_error( "outlier factor must not be negative" );
+      _outlier_factor = factor;
+      return *this;
+    }
+
+
+    // Measures a cost by calling "repeat", which measures one repetition and returns its cost. After each repetition, the
+    // measurement is stopped if "stop( cost of the repetitions so far, repetitions, maximum number of repetitions )" is true,
+    // where the cost of the repetitions so far is aggregated as the final cost.
+    template< typename repeat_t, typename stop_t >
+    cost_t measure_until( repeat_t&& repeat, stop_t&& stop ) const
+    {
+      std::vector<double> samples;
+      samples.reserve( _min_repetitions );
+      while( samples.size() < _max_repetitions )
+      {
+        {
+          trace_span span( "repetition", "measurement" );
+          samples.emplace_back( static_cast<double>( repeat() ) );
+        }
+        if( stop( aggregated( without_outliers( samples ) ), samples.size(), _max_repetitions ) )
+          break;
+        if( samples.size() >= _min_repetitions && precise( samples ) )
+          break;
+      }
+
+      const auto kept = without_outliers( samples );
+      if( detail::measurement_log() != nullptr && kept.size() > 1 )
+        *detail::measurement_log() = variance( kept );
+
+      return static_cast<cost_t>( aggregated( kept ) );
+    }
+
+    // measurement that races against the best cost (see "racing"): only complete measurements are reported to "racing"
+    template< typename repeat_t >
+    cost_t measure( repeat_t&& repeat, const racing_class& racing ) const
+    {
+      bool stopped = false;
+      const cost_t cost = measure_until( repeat, [ & ]( double partial_cost, size_t repetitions, size_t max_repetitions ) {
+        return stopped = racing.stop( partial_cost, repetitions, max_repetitions );
+      } );
+      if( stopped )
+        return racing.stopped_cost( cost );
+
+      racing.report( cost );
+      return cost;
+    }
+
+    template< typename repeat_t >
+    cost_t measure( repeat_t&& repeat ) const
+    {
+      return measure_until( repeat, []( double, size_t, size_t ) { return false; } );
+    }
+
+  private:
+    size_t            _min_repetitions;
+    size_t            _max_repetitions;
+    double            _relative_width; // 0: no confidence target
+    double            _confidence_level;
+    atf::aggregation  _aggregation;
+    double            _trim_fraction;
+    double            _outlier_factor; // 0: no rejection
+
+    bool precise( const std::vector<double>& samples ) const
+    {
+      if( _relative_width == 0.0 )
+        return true;
+
+      const auto kept = without_outliers( samples );
+      if( kept.size() < 2 )
+        return false;
+
+      const double mean       = sum( kept ) / kept.size();
+      const double half_width = detail::student_t_quantile( 1 - ( 1 - _confidence_level ) / 2, kept.size() - 1 ) * std::sqrt( variance( kept ) / kept.size() );
+      return half_width <= _relative_width * std::abs( mean );
+    }
+
+    // sorted repetitions within Tukey's fences
+    std::vector<double> without_outliers( std::vector<double> samples ) const
+    {
+      std::sort( samples.begin(), samples.end() );
+      if( _outlier_factor == 0.0 || samples.size() < 4 )
+        return samples;
+
+      const double q1  = quantile( samples, 0.25 );
+      const double q3  = quantile( samples, 0.75 );
+      const double iqr = q3 - q1;
+      const auto   begin = std::lower_bound( samples.begin(), samples.end(), q1 - _outlier_factor * iqr );
+      const auto   end   = std::upper_bound( samples.begin(), samples.end(), q3 + _outlier_factor * iqr );
+      return std::vector<double>( begin, end );
+    }
+
+    double aggregated( const std::vector<double>& sorted ) const
+    {
+      switch( _aggregation )
+      {
+        case aggregation::median:
+          return quantile( sorted, 0.5 );
+        case aggregation::trimmed_mean:
+        {
+          const size_t trimmed = static_cast<size_t>( _trim_fraction * sorted.size() );
+          return sum( std::vector<double>( sorted.begin() + trimmed, sorted.end() - trimmed ) ) / ( sorted.size() - 2 * trimmed );
+        }
+        case aggregation::min:
+          return sorted.front();
+        default:
+          return sum( sorted ) / sorted.size();
+      }
+    }
+
+    // linear interpolation between the closest ranks
+    static double quantile( const std::vector<double>& sorted, double p )
+    {
+      const double position = p * ( sorted.size() - 1 );
+      const size_t lower    = static_cast<size_t>( position );
+      if( lower + 1 >= sorted.size() )
+        return sorted.back();
+      return sorted[ lower ] + ( position - lower ) * ( sorted[ lower + 1 ] - sorted[ lower ] );
+    }
+
+    static double sum( const std::vector<double>& samples )
+    {
+      double total = 0.0;
+      for( const auto& sample : samples )
+        total += sample;
+      return total;
+    }
+
+    // sample variance
+    static double variance( const std::vector<double>& samples )
+    {
+      const double mean = sum( samples ) / samples.size();
+      double squares = 0.0;
+      for( const auto& sample : samples )
+        squares += ( sample - mean ) * ( sample - mean );
+      return squares / ( samples.size() - 1 );
+    }
+};
+
+// single repetition, to be customized via "repetitions", "confidence", "aggregate", and "reject_outliers"
+inline measurement_class measurement()
+{
+  return measurement_class();
+}
+
+
+// measures "cost_function" according to "measurement", i.e., calls it repeatedly per configuration (e.g., "atf::cpp" and
+// "atf::cf::bash" cost functions, which time a single run)
+template< typename callable >
+auto measured( callable cost_function, const measurement_class& measurement )
+{
+  return [ cost_function, measurement ]( configuration& config ) mutable -> cost_t {
+    return measurement.measure( [ & ]() { return static_cast<double>( cost_function( config ) ); } );
+  };
+}
+
+} // namespace "atf"
+
+#endif /* measurement_h */
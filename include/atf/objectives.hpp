@@ -0,0 +1,139 @@
+#ifndef objectives_h
+#define objectives_h
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "flat_configuration.hpp"
+#include "pareto_archive.hpp"
+#include "detail/cost_function_stages.hpp"
+
+namespace atf
+{
+
+// maps the objective vector of a configuration to the single cost that is minimized (e.g., by the search technique)
+using scalarization = std::function<cost_t( const objective_vector& )>;
+
+
+// cost: objective "i"
+inline scalarization objective( size_t i )
+{
+  return [ i ]( const objective_vector& objectives ) { return objectives.at( i ); };
+}
+
+// cost: sum of the objectives weighted by "weights"
+inline scalarization weighted_sum( const std::vector<double>& weights )
+{
+  return [ weights ]( const objective_vector& objectives ) {
+    if( objectives.size() != weights.size() )
+      throw std::runtime_error( "number of weights differs from the number of objectives" );
+    cost_t cost = 0;
+    for( size_t i = 0 ; i < weights.size() ; ++i )
+      cost += weights[ i ] * objectives[ i ];
+    return cost;
+  };
+}
+
+// cost: largest weighted distance of an objective to the ideal point (default: 0 in all objectives); unlike the weighted sum,
+// every point of the Pareto front is the minimum for some weights
+inline scalarization chebyshev( const std::vector<double>& weights, const objective_vector& ideal = {} )
+{
+  return [ weights, ideal ]( const objective_vector& objectives ) {
+    if( objectives.size() != weights.size() || ( !ideal.empty() && ideal.size() != weights.size() ) )
+      throw std::runtime_error( "number of weights or ideal objectives differs from the number of objectives" );
+    cost_t cost = -std::numeric_limits<cost_t>::infinity();
+    for( size_t i = 0 ; i < weights.size() ; ++i )
+      cost = std::max( cost, weights[ i ] * ( objectives[ i ] - ( ideal.empty() ? 0 : ideal[ i ] ) ) );
+    return cost;
+  };
+}
+
+
+namespace detail
+{
+
+// if set, a cost function that returns an objective vector on the calling thread stores the vector here (see "scalarized_cost_function")
+inline objective_vector*& objective_log()
+{
+  static thread_local objective_vector* log = nullptr;
+  return log;
+}
+
+
+// true if the cost function returns an objective vector rather than a single cost (for cost functions with a compile stage:
+// if their measure stage does)
+template< typename callable, bool = has_compile_stage<callable>::value >
+struct returns_objectives
+  : std::is_same< std::decay_t<decltype( call_cost_function( std::declval<callable&>(), std::declval<flat_configuration&>(), std::declval<configuration&>(), 0 ) )>, objective_vector > {};
+
+template< typename callable >
+struct returns_objectives< callable, true >
+  : std::is_same< std::decay_t<decltype( std::declval<callable&>().measure( std::declval<compiled_program_t<callable>&>() ) )>, objective_vector > {};
+
+
+// Cost function that calls "cf", which returns an objective vector, stores the vector to "objective_log()", and returns its
+// scalarization as the cost. Cost functions with a compile stage keep it.
+template< typename callable, bool = has_compile_stage<callable>::value >
+class scalarized_cost_function
+{
+  public:
+    scalarized_cost_function( callable& cf, size_t num_objectives, const atf::scalarization& scalarization )
+      : _cf( cf ), _num_objectives( num_objectives ), _scalarization( scalarization )
+    {}
+
+    template< typename cf_t = callable >
+    auto operator()( configuration& config ) -> decltype( std::declval<cf_t&>()( config ), cost_t() )
+    {
+      return scalarized( _cf( config ) );
+    }
+
+    template< typename cf_t = callable >
+    auto operator()( flat_configuration& config ) -> decltype( std::declval<cf_t&>()( config ), cost_t() )
+    {
+      return scalarized( _cf( config ) );
+    }
+
+  protected:
+    callable&           _cf;
+    size_t              _num_objectives;
+    atf::scalarization  _scalarization;
+
+    cost_t scalarized( const objective_vector& objectives ) const
+    {
+      if( objectives.size() != _num_objectives )
+        throw std::runtime_error( "cost function returned " + std::to_string( objectives.size() ) + " objectives, expected " + std::to_string( _num_objectives ) );
+      const cost_t cost = _scalarization( objectives );
+      if( objective_log() != nullptr )
+        *objective_log() = objectives;
+      return cost;
+    }
+};
+
+template< typename callable >
+class scalarized_cost_function< callable, true > : public scalarized_cost_function< callable, false >
+{
+  public:
+    using scalarized_cost_function< callable, false >::scalarized_cost_function;
+
+    compiled_program_t<callable> compile( configuration& config )
+    {
+      return this->_cf.compile( config );
+    }
+
+    cost_t measure( compiled_program_t<callable>& compiled )
+    {
+      return this->scalarized( this->_cf.measure( compiled ) );
+    }
+};
+
+} // namespace "detail"
+
+} // namespace "atf"
+
+#endif /* objectives_h */
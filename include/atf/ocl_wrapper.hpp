@@ -16,6 +16,9 @@
 
 #include "tp_value.hpp"
 #include "helper.hpp"
+#include "racing.hpp"
+#include "measurement.hpp"
+#include "trace.hpp"
 
 
 namespace atf
@@ -232,8 +235,17 @@ class ocl_cf_class
       _warm_ups = warm_ups;
     }
 
+    // shorthand for a fixed number of repetitions of the measurement policy
     void evaluations(size_t evaluations) {
-      _evaluations = evaluations;
+      _measurement.repetitions(evaluations, evaluations);
+    }
+
+    void measurement(const measurement_class& measurement) {
+      _measurement = measurement;
+    }
+
+    void racing(const racing_class& racing) {
+      _racing = racing;
     }
 
     template<size_t index>
@@ -243,87 +255,75 @@ class ocl_cf_class
       std::get<index>(_check_result) = true;
     }
 
-    size_t operator()( configuration& configuration )
+    // kernel compiled for a configuration by "compile", to be run by "measure"
+    struct compiled_kernel
     {
-      // update tp values
-      for( auto& tp : configuration )
-      {
-        auto tp_value = tp.second;
-        tp_value.update_tp();
-      }
-
-      size_t gs_0 = std::get<0>( _global_size_pattern ).evaluate();
-      size_t gs_1 = std::get<1>( _global_size_pattern ).evaluate();
-      size_t gs_2 = std::get<2>( _global_size_pattern ).evaluate();
-
-      size_t ls_0 = std::get<0>( _local_size_pattern ).evaluate();
-      size_t ls_1 = std::get<1>( _local_size_pattern ).evaluate();
-      size_t ls_2 = std::get<2>( _local_size_pattern ).evaluate();
-
-      // create flags
-      std::stringstream flags;
-
-      for( const auto& tp : configuration )
-        flags << " -D " << tp.first << "=" << tp.second.value();
+      cl::Program          program;
+      cl::Kernel           kernel;
+      nd_range_t           global_size;
+      nd_range_t           local_size;
+      ::atf::configuration configuration;
+    };
 
-      // set additional kernel flags
-      flags << " " << _kernel_flags;
 
+    // rebuilds the shared program for "configuration", and measures it
+    size_t operator()( configuration& configuration )
+    {
+      auto kernel = build( configuration, _program );
+      return measure( kernel );
+    }
 
-      // compile kernel
-      try
-      {
-        auto start = std::chrono::steady_clock::now();
-
-        _program.build( std::vector<cl::Device>( 1, _device ), flags.str().c_str() );
 
-        auto end = std::chrono::steady_clock::now();
-        auto runtime_in_sec = std::chrono::duration_cast<std::chrono::milliseconds>( end - start ).count();
-      }
-      catch( cl::Error& err )
-      {
-        if( err.err() == CL_BUILD_PROGRAM_FAILURE )
-        {
-          auto buildLog = _program.getBuildInfo<CL_PROGRAM_BUILD_LOG>( _device );
-          std::cout << std::endl << "Build failed! Log:" << std::endl << buildLog << std::endl;
-        }
+    // compile stage of pipelined evaluation: builds a program of its own for "configuration", such that it can be built while
+    // the kernel of another configuration is measured
+    compiled_kernel compile( configuration& configuration )
+    {
+      return build( configuration, cl::Program( _context,
+                                                cl::Program::Sources( 1, std::make_pair( _kernel_source.c_str(), _kernel_source.length() ) )
+                                   ) );
+    }
 
-        throw std::exception();
-      }
 
-      auto kernel = cl::Kernel( _program, _kernel_name.c_str(), &error ); check_error( error );
+    // runs a compiled kernel and returns its runtime in ns
+    size_t measure( compiled_kernel& compiled )
+    {
+      auto& kernel = compiled.kernel;
 
       // set kernel arguments
       this->set_kernel_args( kernel, std::make_index_sequence<sizeof...(Ts)>() );
 
       // start kernel
       cl::Event event;
-      cl::NDRange global_size( gs_0, gs_1, gs_2 );
-      cl::NDRange local_size( ls_0, ls_1, ls_2 );
+      cl::NDRange global_size( compiled.global_size[ 0 ], compiled.global_size[ 1 ], compiled.global_size[ 2 ] );
+      cl::NDRange local_size( compiled.local_size[ 0 ], compiled.local_size[ 1 ], compiled.local_size[ 2 ] );
 
       // warm ups
       for( size_t i = 0 ; i < _warm_ups ; ++i )
       {
         this->fill_buffers( false, std::make_index_sequence<sizeof...(Ts)>() );
+        trace_span span( "enqueue warm up", "opencl" );
         error = _command_queue.enqueueNDRangeKernel( kernel, cl::NullRange, global_size, local_size, NULL, &event ); if( error != CL_SUCCESS ) throw std::exception();
       }
 
-      // kernel launch with profiling
-      cl_ulong kernel_runtime_in_ns = 0;
-      cl_ulong start_time;
-      cl_ulong end_time;
-
-      for( size_t i = 0 ; i < _evaluations ; ++i )
+      // kernel launch with profiling, repeated according to the measurement policy (and stopped if the configuration cannot beat the best one)
+      auto run_kernel = [ & ]() -> double
       {
+        cl_ulong start_time;
+        cl_ulong end_time;
+
         this->fill_buffers( false, std::make_index_sequence<sizeof...(Ts)>() );
-        error = _command_queue.enqueueNDRangeKernel( kernel, cl::NullRange, global_size, local_size, NULL, &event ); if( error != CL_SUCCESS ) throw std::exception();
-        error = event.wait(); check_error( error );
+        {
+          trace_span span( "run kernel", "opencl" );
+          error = _command_queue.enqueueNDRangeKernel( kernel, cl::NullRange, global_size, local_size, NULL, &event ); if( error != CL_SUCCESS ) throw std::exception();
+          error = event.wait(); check_error( error );
+        }
 
         event.getProfilingInfo( CL_PROFILING_COMMAND_START, &start_time );
         event.getProfilingInfo( CL_PROFILING_COMMAND_END,   &end_time   );
 
-        kernel_runtime_in_ns += end_time - start_time;
-      }
+        return static_cast<double>( end_time - start_time );
+      };
+      const size_t runtime_in_ns = static_cast<size_t>( _measurement.measure( run_kernel, _racing ) );
 
       // check result
       if( std::any_of(_check_result.begin(), _check_result.end(), [](auto b) { return b; }) )
@@ -331,13 +331,9 @@ class ocl_cf_class
 
       // save thread configuration
       if( _thread_configuration != nullptr )
-      {
-        nd_range_t gs = { gs_0, gs_1, gs_2 };
-        nd_range_t ls = { ls_0, ls_1, ls_2 };
-        (*_thread_configuration)[ configuration ] = { gs, ls };
-      }
+        (*_thread_configuration)[ compiled.configuration ] = { compiled.global_size, compiled.local_size };
 
-      return kernel_runtime_in_ns / _evaluations;
+      return runtime_in_ns;
     }
 
   private:
@@ -351,7 +347,8 @@ class ocl_cf_class
     std::string                    _kernel_name;
     std::string                    _kernel_flags;
     size_t                         _warm_ups = 0;
-    size_t                         _evaluations = 1;
+    measurement_class              _measurement;
+    racing_class                   _racing = ::atf::no_racing();
 
     std::tuple<Ts...>              _kernel_inputs;
     std::vector<cl::Buffer>        _kernel_buffers;
@@ -368,6 +365,64 @@ class ocl_cf_class
     std::tuple<comparator<typename Ts::elem_type>...> _gold_comparator;
 
 
+    // builds "program" for "configuration"
+    compiled_kernel build( configuration& configuration, cl::Program program )
+    {
+      // update tp values
+      for( auto& tp : configuration )
+      {
+        auto tp_value = tp.second;
+        tp_value.update_tp();
+      }
+
+      size_t gs_0 = std::get<0>( _global_size_pattern ).evaluate();
+      size_t gs_1 = std::get<1>( _global_size_pattern ).evaluate();
+      size_t gs_2 = std::get<2>( _global_size_pattern ).evaluate();
+
+      size_t ls_0 = std::get<0>( _local_size_pattern ).evaluate();
+      size_t ls_1 = std::get<1>( _local_size_pattern ).evaluate();
+      size_t ls_2 = std::get<2>( _local_size_pattern ).evaluate();
+
+      compiled_kernel compiled;
+      compiled.global_size   = { gs_0, gs_1, gs_2 };
+      compiled.local_size    = { ls_0, ls_1, ls_2 };
+      compiled.configuration = configuration;
+
+      // create flags
+      std::stringstream flags;
+
+      for( const auto& tp : configuration )
+        flags << " -D " << tp.first << "=" << tp.second.value();
+
+      // set additional kernel flags
+      flags << " " << _kernel_flags;
+
+
+      // compile kernel
+      trace_span span( "compile kernel", "opencl" );
+      compiled.program = program;
+      try
+      {
+        compiled.program.build( std::vector<cl::Device>( 1, _device ), flags.str().c_str() );
+      }
+      catch( cl::Error& err )
+      {
+        if( err.err() == CL_BUILD_PROGRAM_FAILURE )
+        {
+          auto buildLog = compiled.program.getBuildInfo<CL_PROGRAM_BUILD_LOG>( _device );
+          std::cout << std::endl << "Build failed! Log:" << std::endl << buildLog << std::endl;
+        }
+
+        throw std::exception();
+      }
+
+      cl_int compile_error;
+      compiled.kernel = cl::Kernel( compiled.program, _kernel_name.c_str(), &compile_error ); check_error( compile_error );
+
+      return compiled;
+    }
+
+
     // helper for creating buffers
     template< size_t... Is >
     void create_buffers( std::index_sequence<Is...> )
@@ -411,6 +466,7 @@ class ocl_cf_class
     template< size_t... Is >
     void fill_buffers( bool init, std::index_sequence<Is...> )
     {
+      trace_span span( "fill buffers", "opencl" );
       buffer_pos = 0;
       fill_buffers_impl( init, std::get<Is>( _kernel_inputs )... );
     }
@@ -500,6 +556,7 @@ class ocl_cf_class
     template< size_t... Is >
     void check_result_helper( std::index_sequence<Is...> )
     {
+      trace_span span( "check result", "opencl" );
       buffer_pos = 0;
       check_result_helper_impl( std::make_tuple( std::get<Is>( _check_result ) ,
                                                  std::cref(std::get<Is>( _kernel_inputs )) ,
@@ -4,6 +4,7 @@
 
 
 #include "helper.hpp"
+#include "detail/candidate_values.hpp"
 
 
 namespace atf {
@@ -81,6 +82,13 @@ class op_wrapper_class
       
       return _func( lhs, rhs );
     }
+
+    // operands of the expression, e.g., for keying search space files by the parameters of predicates
+    template< typename hash_t >
+    bool hash_parameters( hash_t& hash ) const
+    {
+      return detail::hash_parameters( hash, _lhs ) && detail::hash_parameters( hash, _rhs );
+    }
 };
 
 
@@ -0,0 +1,179 @@
+#ifndef pareto_archive_h
+#define pareto_archive_h
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "tp_value.hpp"
+
+namespace atf
+{
+
+using cost_t           = double;
+using objective_vector = std::vector<cost_t>; // costs of a configuration w.r.t. multiple objectives, each to be minimized
+
+
+// Pareto front of the configurations evaluated w.r.t. multiple objectives: the configurations whose objective vectors are not
+// weakly dominated by another one's (i.e., no other one is at least as good in all objectives). The front is kept sorted
+// lexicographically, such that only the points with a smaller (larger) first objective are checked for dominating (being
+// dominated by) a new point. For two objectives, the front is a staircase: whether a point is dominated is decided by binary
+// search, but inserting it (and erasing the points it dominates) moves the following points, i.e., takes linear time.
+class pareto_archive
+{
+  public:
+    struct point
+    {
+      objective_vector objectives;
+      configuration    config;
+    };
+
+    pareto_archive()
+      : _points(), _hypervolume_reference(), _hypervolume( 0.0 ), _hypervolume_valid( false )
+    {}
+
+
+    // inserts the point, unless it is weakly dominated by a point of the front, and removes the points it dominates;
+    // returns true if inserted
+    bool insert( const objective_vector& objectives, const configuration& config )
+    {
+      if( !_points.empty() && objectives.size() != _points.front().objectives.size() )
+        throw std::runtime_error( "objective vectors differ in size" );
+      if( objectives.empty() || dominated( objectives ) )
+        return false;
+
+      // points with a smaller first objective cannot be dominated by the new point
+      const auto first = std::lower_bound( _points.begin(), _points.end(), objectives[ 0 ], []( const point& p, cost_t value ) { return p.objectives[ 0 ] < value; } );
+      if( objectives.size() == 2 )
+      {
+        // the dominated points follow "first" in a contiguous range (the second objective falls along the staircase)
+        const auto last = std::find_if( first, _points.end(), [ & ]( const point& p ) { return p.objectives[ 1 ] < objectives[ 1 ]; } );
+        _points.erase( first, last );
+      }
+      else
+        _points.erase( std::remove_if( first, _points.end(), [ & ]( const point& p ) { return weakly_dominates( objectives, p.objectives ); } ), _points.end() );
+
+      const auto position = std::lower_bound( _points.begin(), _points.end(), objectives, []( const point& p, const objective_vector& value ) { return p.objectives < value; } );
+      _points.insert( position, point{ objectives, config } );
+      _hypervolume_valid = false;
+      return true;
+    }
+
+
+    // true if a point of the front is at least as good as "objectives" in all objectives
+    bool dominated( const objective_vector& objectives ) const
+    {
+      // only points with a smaller or equal first objective can dominate
+      const auto end = std::upper_bound( _points.begin(), _points.end(), objectives[ 0 ], []( cost_t value, const point& p ) { return value < p.objectives[ 0 ]; } );
+      if( end == _points.begin() )
+        return false;
+
+      // for two objectives, the last of these points has the smallest second objective
+      if( objectives.size() == 2 )
+        return std::prev( end )->objectives[ 1 ] <= objectives[ 1 ];
+
+      return std::any_of( _points.begin(), end, [ & ]( const point& p ) { return weakly_dominates( p.objectives, objectives ); } );
+    }
+
+
+    // Volume of the objective space dominated by the front and bounded by "reference" (points not better than the reference in
+    // all objectives do not contribute). Computed exactly by slicing along the last objective, and cached until the front
+    // changes.
+    double hypervolume( const objective_vector& reference ) const
+    {
+      if( !_hypervolume_valid || reference != _hypervolume_reference )
+      {
+        std::vector<objective_vector> points;
+        for( const auto& p : _points )
+          if( p.objectives.size() == reference.size() && std::equal( p.objectives.begin(), p.objectives.end(), reference.begin(), std::less<cost_t>() ) )
+            points.emplace_back( p.objectives );
+        if( !_points.empty() && _points.front().objectives.size() != reference.size() )
+          throw std::runtime_error( "reference point differs in size from the objective vectors" );
+
+        _hypervolume           = volume( points, reference, reference.size() );
+        _hypervolume_reference = reference;
+        _hypervolume_valid     = true;
+      }
+      return _hypervolume;
+    }
+
+
+    size_t size() const
+    {
+      return _points.size();
+    }
+
+    bool empty() const
+    {
+      return _points.empty();
+    }
+
+    // points in lexicographic order of their objective vectors
+    const std::vector<point>& points() const
+    {
+      return _points;
+    }
+
+    auto begin() const
+    {
+      return _points.begin();
+    }
+
+    auto end() const
+    {
+      return _points.end();
+    }
+
+  private:
+    std::vector<point>         _points;
+    mutable objective_vector   _hypervolume_reference;
+    mutable double             _hypervolume;
+    mutable bool               _hypervolume_valid;
+
+    static bool weakly_dominates( const objective_vector& lhs, const objective_vector& rhs )
+    {
+      return std::equal( lhs.begin(), lhs.end(), rhs.begin(), std::less_equal<cost_t>() );
+    }
+
+    // volume dominated by "points" in their first "dims" objectives (the points need not be mutually non-dominated)
+    static double volume( std::vector<objective_vector> points, const objective_vector& reference, size_t dims )
+    {
+      if( points.empty() )
+        return 0.0;
+
+      const size_t last = dims - 1;
+      std::sort( points.begin(), points.end(), [ last ]( const objective_vector& lhs, const objective_vector& rhs ) { return lhs[ last ] < rhs[ last ]; } );
+      if( dims == 1 )
+        return reference[ 0 ] - points.front()[ 0 ];
+
+      // sweep along the last objective: between two points, the slice's area is dominated by the points swept so far
+      double volume_sum = 0.0;
+      if( dims == 2 )
+      {
+        double min_first = reference[ 0 ];
+        for( size_t i = 0 ; i < points.size() ; ++i )
+        {
+          min_first = std::min( min_first, points[ i ][ 0 ] );
+          const double next = i + 1 < points.size() ? points[ i + 1 ][ 1 ] : reference[ 1 ];
+          volume_sum += ( reference[ 0 ] - min_first ) * ( next - points[ i ][ 1 ] );
+        }
+        return volume_sum;
+      }
+
+      std::vector<objective_vector> swept;
+      for( size_t i = 0 ; i < points.size() ; ++i )
+      {
+        swept.emplace_back( points[ i ] );
+        const double next = i + 1 < points.size() ? points[ i + 1 ][ last ] : reference[ last ];
+        if( next > points[ i ][ last ] )
+          volume_sum += volume( swept, reference, last ) * ( next - points[ i ][ last ] );
+      }
+      return volume_sum;
+    }
+};
+
+} // namespace "atf"
+
+#endif /* pareto_archive_h */
@@ -3,6 +3,8 @@
 
 #include <random>
 #include <vector>
+#include <utility>
+#include <algorithm>
 
 #include "search_technique.hpp"
 #include "detail/pso/multivariate_distribution.hpp"
@@ -39,31 +41,49 @@ class particle_swarm_class : public search_technique {
       }
     }
 
+    /* Returns the positions of the next particles of the batch; a batch ends with the round, as the swarms move afterwards. */
     std::set<coordinates> get_next_coordinates() override
     {
-      ++_pos;
-      if (_pos == M * N) {
-        _pos = 0;
+      _batch.clear();
+      std::set<coordinates> points;
+      do {
+        ++_pos;
+        if (_pos == M * N) {
+          _pos = 0;
+
+          for (auto &sw : _swarms) {
+            sw.move(_dist, x_func{});
+          }
+        }
 
-        for (auto &sw : _swarms) {
-          sw.move(_dist, x_func{});
+        /* Get current particle */
+        detail::pso::particle& p = _swarms[_pos % N][_pos % M];
+        /* Check if current particle has valid position. If not, use fmod to map its position to the coordinate_space. */
+        if (!valid_coordinates(p.position())) {
+          p.set_position(clamp_coordinates_mod(p.position()));
         }
-      }
 
-      /* Get current particle */
-      detail::pso::particle& p = _swarms[_pos % N][_pos % M];
-      /* Check if current particle has valid position. If not, use fmod to map its position to the coordinate_space. */
-      if (!valid_coordinates(p.position())) {
-        p.set_position(clamp_coordinates_mod(p.position()));
-      }
+        _batch.emplace_back(_pos, p.position());
+        points.insert(p.position());
+      } while (_batch.size() < _batch_size && _pos + 1 < M * N);
 
-      return { p.position() };
+      return points;
     }
 
     void report_costs( const std::map<coordinates, cost_t>& costs ) override
     {
-      cost_t cost = costs.begin()->second;
-      _swarms[_pos % N].report_fitness(cost, _pos % M);
+      for (const auto &requested : _batch) {
+        auto cost = costs.find(requested.second);
+        if (cost != costs.end()) {
+          _swarms[requested.first % N].report_fitness(cost->second, requested.first % M);
+        }
+      }
+      _batch.clear();
+    }
+
+    void set_batch_size(size_t batch_size) override
+    {
+      _batch_size = std::max(batch_size, std::size_t{1});
     }
 
     void finalize() override
@@ -71,6 +91,24 @@ class particle_swarm_class : public search_technique {
 
     }
 
+    void save_state(std::ostream& out) const override
+    {
+      detail::save_value(out, _pos);
+      detail::save_value(out, _dist);
+      for (const auto &sw : _swarms) {
+        sw.save_state(out);
+      }
+    }
+
+    void load_state(std::istream& in) override
+    {
+      detail::load_value(in, _pos);
+      detail::load_value(in, _dist);
+      for (auto &sw : _swarms) {
+        sw.load_state(in);
+      }
+    }
+
   private:
     /** dimensionality search space */
     size_t _dimensionality{0};
@@ -80,6 +118,10 @@ class particle_swarm_class : public search_technique {
     distribution_type _dist;
     /** index of current particle */
     std::size_t _pos {0};
+    /** maximum number of particles per request */
+    std::size_t _batch_size {1};
+    /** indices and positions of the particles of the current request */
+    std::vector<std::pair<std::size_t, coordinates>> _batch;
 };
 
 /**
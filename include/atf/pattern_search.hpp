@@ -2,6 +2,7 @@
 #define pattern_search_h
 
 #include "search_technique.hpp"
+#include "detail/technique_state.hpp"
 
 namespace atf
 {
@@ -130,6 +131,36 @@ class pattern_search : public search_technique
     void finalize() override
     {}
 
+    void save_state( std::ostream& out ) const override
+    {
+      detail::save_value( out, _base );
+      detail::save_value( out, _base_fitness );
+      detail::save_value( out, _exploratory_coordinates );
+      detail::save_value( out, _exploratory_coordinates_fitness );
+      detail::save_value( out, _pattern_coordinates );
+      detail::save_value( out, _pattern_coordinates_fitness );
+      detail::save_value( out, _trigger );
+      detail::save_value( out, _current_parameter );
+      detail::save_value( out, _step_size );
+      detail::save_value( out, static_cast<int>( _current_state ) );
+    }
+
+    void load_state( std::istream& in ) override
+    {
+      int current_state;
+      detail::load_value( in, _base );
+      detail::load_value( in, _base_fitness );
+      detail::load_value( in, _exploratory_coordinates );
+      detail::load_value( in, _exploratory_coordinates_fitness );
+      detail::load_value( in, _pattern_coordinates );
+      detail::load_value( in, _pattern_coordinates_fitness );
+      detail::load_value( in, _trigger );
+      detail::load_value( in, _current_parameter );
+      detail::load_value( in, _step_size );
+      detail::load_value( in, current_state );
+      _current_state = static_cast<State>( current_state );
+    }
+
   private:
     /** state to indicate what do do next */
     enum State{
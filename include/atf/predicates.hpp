@@ -2,7 +2,11 @@
 #ifndef predicates_h
 #define predicates_h
 
+#include <limits>
+#include <algorithm>
+
 #include "detail/utility.hpp"
+#include "detail/candidate_values.hpp"
 #include "op_wrapper.hpp"
 
 namespace atf {
@@ -10,63 +14,424 @@ namespace atf {
 auto pow_2 = []( auto i )->int{ return pow(2,i); };
 
 
+// The predicates are classes that, in addition to being callable, narrow the candidate values of integer intervals
+// (see "detail/candidate_values.hpp"), so that TPs can enumerate their valid values without checking every value of the range.
+
 // divides
+template< typename T >
+class divides_class
+{
+  public:
+    divides_class( const T& M )
+      : _M( M )
+    {}
+
+    template< typename I >
+    bool operator()( I i ) const
+    {
+      return (_M / i) * i == _M;
+    }
+
+    template< typename I >
+    void narrow( detail::candidate_values<I>& c ) const
+    {
+      I M;
+      if( detail::integral_value( _M, M ) && M > 0 )
+      {
+        c.divisors_of = M;
+        c.narrowed    = true;
+      }
+    }
+
+    template< typename hash_t >
+    bool hash_parameters( hash_t& hash ) const
+    {
+      return detail::hash_parameters( hash, _M );
+    }
+
+  private:
+    T _M;
+};
+
 template< typename T> auto divides( const T& M ) {
 
-  return [=]( auto i )->bool{ return (M / i) * i == M; };
+  return divides_class<T>( M );
 }
 
 // multiple_of
+template< typename T >
+class multiple_of_class
+{
+  public:
+    multiple_of_class( const T& M )
+      : _M( M )
+    {}
+
+    template< typename I >
+    bool operator()( I i ) const
+    {
+      return (i / _M) * _M == i;
+    }
+
+    template< typename I >
+    void narrow( detail::candidate_values<I>& c ) const
+    {
+      I M;
+      if( detail::integral_value( _M, M ) && M > 0 )
+      {
+        c.multiples_of = c.multiples_of == 0 ? M : c.multiples_of / detail::gcd( c.multiples_of, M ) * M;
+        c.narrowed     = true;
+      }
+    }
+
+    template< typename hash_t >
+    bool hash_parameters( hash_t& hash ) const
+    {
+      return detail::hash_parameters( hash, _M );
+    }
+
+  private:
+    T _M;
+};
+
 template< typename T> auto multiple_of( const T& M )
 {
-  return [=]( auto i )->bool{ return (i / M) * M == i; };
+  return multiple_of_class<T>( M );
 }
 
 // less than
+template< typename T >
+class less_than_class
+{
+  public:
+    less_than_class( const T& M )
+      : _M( M )
+    {}
+
+    template< typename I >
+    bool operator()( I i ) const
+    {
+      return i < _M;
+    }
+
+    template< typename I >
+    void narrow( detail::candidate_values<I>& c ) const
+    {
+      I M;
+      if( !detail::integral_value( _M, M ) )
+        return;
+
+      if( M == std::numeric_limits<I>::min() )
+        c.empty = true;
+      else
+        c.max = std::min( c.max, static_cast<I>( M - 1 ) );
+      c.narrowed = true;
+    }
+
+    template< typename hash_t >
+    bool hash_parameters( hash_t& hash ) const
+    {
+      return detail::hash_parameters( hash, _M );
+    }
+
+  private:
+    T _M;
+};
+
 template< typename T>
 auto less_than( const T& M )
 {
-  return [=]( auto i )->bool{ return i < M; };
+  return less_than_class<T>( M );
 }
 
 // greater than
+template< typename T >
+class greater_than_class
+{
+  public:
+    greater_than_class( const T& M )
+      : _M( M )
+    {}
+
+    template< typename I >
+    bool operator()( I i ) const
+    {
+      return i > _M;
+    }
+
+    template< typename I >
+    void narrow( detail::candidate_values<I>& c ) const
+    {
+      I M;
+      if( !detail::integral_value( _M, M ) )
+        return;
+
+      if( M == std::numeric_limits<I>::max() )
+        c.empty = true;
+      else
+        c.min = std::max( c.min, static_cast<I>( M + 1 ) );
+      c.narrowed = true;
+    }
+
+    template< typename hash_t >
+    bool hash_parameters( hash_t& hash ) const
+    {
+      return detail::hash_parameters( hash, _M );
+    }
+
+  private:
+    T _M;
+};
+
 template< typename T>
 auto greater_than( const T& M )
 {
-  return [=]( auto i )->bool{ return i > M; };
+  return greater_than_class<T>( M );
 }
 
 // less than or equal
+template< typename T >
+class less_than_or_eq_class
+{
+  public:
+    less_than_or_eq_class( const T& M )
+      : _M( M )
+    {}
+
+    template< typename I >
+    bool operator()( I i ) const
+    {
+      return i <= _M;
+    }
+
+    template< typename I >
+    void narrow( detail::candidate_values<I>& c ) const
+    {
+      I M;
+      if( !detail::integral_value( _M, M ) )
+        return;
+
+      c.max      = std::min( c.max, M );
+      c.narrowed = true;
+    }
+
+    template< typename hash_t >
+    bool hash_parameters( hash_t& hash ) const
+    {
+      return detail::hash_parameters( hash, _M );
+    }
+
+  private:
+    T _M;
+};
+
 template< typename T>
 auto less_than_or_eq( const T& M )
 {
-  return [=]( auto i )->bool{ return i <= M; };
+  return less_than_or_eq_class<T>( M );
 }
 
 // greater than or equal
+template< typename T >
+class greater_than_or_eq_class
+{
+  public:
+    greater_than_or_eq_class( const T& M )
+      : _M( M )
+    {}
+
+    template< typename I >
+    bool operator()( I i ) const
+    {
+      return i >= _M;
+    }
+
+    template< typename I >
+    void narrow( detail::candidate_values<I>& c ) const
+    {
+      I M;
+      if( !detail::integral_value( _M, M ) )
+        return;
+
+      c.min      = std::max( c.min, M );
+      c.narrowed = true;
+    }
+
+    template< typename hash_t >
+    bool hash_parameters( hash_t& hash ) const
+    {
+      return detail::hash_parameters( hash, _M );
+    }
+
+  private:
+    T _M;
+};
+
 template< typename T>
 auto greater_than_or_eq( const T& M )
 {
-  return [=]( auto i )->bool{ return i >= M; };
+  return greater_than_or_eq_class<T>( M );
 }
 
 
 // equal
+template< typename T >
+class equal_class
+{
+  public:
+    equal_class( const T& M )
+      : _M( M )
+    {}
+
+    template< typename I >
+    bool operator()( I i ) const
+    {
+      return i == _M;
+    }
+
+    template< typename I >
+    void narrow( detail::candidate_values<I>& c ) const
+    {
+      I M;
+      if( !detail::integral_value( _M, M ) )
+        return;
+
+      c.min      = std::max( c.min, M );
+      c.max      = std::min( c.max, M );
+      c.narrowed = true;
+    }
+
+    template< typename hash_t >
+    bool hash_parameters( hash_t& hash ) const
+    {
+      return detail::hash_parameters( hash, _M );
+    }
+
+  private:
+    T _M;
+};
+
 template< typename T>
 auto equal( const T& M )
 {
-  return [=]( auto i )->bool{ return i == M; };
+  return equal_class<T>( M );
 }
 
 
 // unequal
+template< typename T >
+class unequal_class
+{
+  public:
+    unequal_class( const T& M )
+      : _M( M )
+    {}
+
+    template< typename I >
+    bool operator()( I i ) const
+    {
+      return i != _M;
+    }
+
+    template< typename hash_t >
+    bool hash_parameters( hash_t& hash ) const
+    {
+      return detail::hash_parameters( hash, _M );
+    }
+
+  private:
+    T _M;
+};
+
 template< typename T>
 auto unequal( const T& M )
 {
-  return [=]( auto i )->bool{ return i != M; };
+  return unequal_class<T>( M );
 }
 
 
+// conjunction of predicates; narrows the candidates by both predicates
+template< typename func_t_1, typename func_t_2 >
+class and_class
+{
+  public:
+    and_class( const func_t_1& lhs, const func_t_2& rhs )
+      : _lhs( lhs ), _rhs( rhs )
+    {}
+
+    template< typename I >
+    bool operator()( I x ) const
+    {
+      if( _lhs(x) ==  false )  // enables short circuit evaluation
+        return false;
+      else
+        return static_cast<bool>( _rhs(x) );
+    }
+
+    template< typename I >
+    void narrow( detail::candidate_values<I>& c ) const
+    {
+      detail::narrow_candidates( _lhs, c, 0 );
+      detail::narrow_candidates( _rhs, c, 0 );
+    }
+
+    template< typename hash_t >
+    bool hash_parameters( hash_t& hash ) const
+    {
+      return detail::hash_parameters( hash, _lhs ) && detail::hash_parameters( hash, _rhs );
+    }
+
+  private:
+    func_t_1 _lhs;
+    func_t_2 _rhs;
+};
+
+
+// disjunction of predicates
+template< typename func_t_1, typename func_t_2 >
+class or_class
+{
+  public:
+    or_class( const func_t_1& lhs, const func_t_2& rhs )
+      : _lhs( lhs ), _rhs( rhs )
+    {}
+
+    template< typename I >
+    bool operator()( I x ) const
+    {
+      if( _lhs(x) ==  true )  // enables short circuit evaluation
+        return true;
+      else
+        return static_cast<bool>( _rhs(x) );
+    }
+
+    template< typename hash_t >
+    bool hash_parameters( hash_t& hash ) const
+    {
+      return detail::hash_parameters( hash, _lhs ) && detail::hash_parameters( hash, _rhs );
+    }
+
+  private:
+    func_t_1 _lhs;
+    func_t_2 _rhs;
+};
+
+
+namespace detail
+{
+
+// the parameters of conjunctions and disjunctions are known iff the parameters of both predicates are known
+template< typename func_t_1, typename func_t_2 >
+struct has_known_parameters< and_class<func_t_1,func_t_2> >
+  : std::integral_constant< bool, has_known_parameters<func_t_1>::value && has_known_parameters<func_t_2>::value > {};
+
+template< typename func_t_1, typename func_t_2 >
+struct has_known_parameters< or_class<func_t_1,func_t_2> >
+  : std::integral_constant< bool, has_known_parameters<func_t_1>::value && has_known_parameters<func_t_2>::value > {};
+
+} // namespace "detail"
+
+
 } // namespace "atf"
 
 
@@ -82,13 +447,7 @@ template<	typename func_t_1,
 >
 auto operator&&( func_t_1 lhs, func_t_2 rhs )
 {
-  return [=]( auto x )
-  {
-    if( lhs(x) ==  false )  // enables short circuit evaluation
-      return false;
-    else
-      return static_cast<bool>( rhs(x) );
-  };
+  return atf::and_class<func_t_1,func_t_2>( lhs, rhs );
 }
 
 
@@ -103,13 +462,7 @@ template<	typename func_t_1,
 >
 auto operator||( func_t_1 lhs, func_t_2 rhs )
 {
-  return [=]( auto x )
-  {
-    if( lhs(x) ==  true )  // enables short circuit evaluation
-      return true;
-    else
-      return static_cast<bool>( rhs(x) );
-  };
+  return atf::or_class<func_t_1,func_t_2>( lhs, rhs );
 }
 
 
@@ -0,0 +1,111 @@
+#ifndef racing_h
+#define racing_h
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <limits>
+#include <stdexcept>
+
+#include "tuning_status.hpp"
+
+namespace atf
+{
+
+// Racing of measurements: a measurement that consists of repetitions (e.g., the "evaluations" of a kernel) is stopped once the
+// cost of its repetitions so far (aggregated as its final cost) exceeds "margin" times the best cost measured completely so far,
+// as the configuration is then unlikely to beat the best one. A stopped measurement costs at least this limit, such that it
+// never becomes the best one. Copies share the best cost, such that all copies of a cost function race against the same cost.
+class racing_class
+{
+  public:
+    racing_class( double margin, size_t min_repetitions )
+      : _margin( margin ), _min_repetitions( min_repetitions ), _best( std::make_shared<best_measurement>() )
+    {}
+
+    bool enabled() const
+    {
+      return _margin != std::numeric_limits<double>::infinity();
+    }
+
+    // cost beyond which a measurement is stopped (infinity: no limit, e.g., before the first complete measurement)
+    double limit() const
+    {
+      if( !enabled() )
+        return std::numeric_limits<double>::infinity();
+
+      std::lock_guard<std::mutex> lock( _best->mutex );
+      if( _best->cost == std::numeric_limits<cost_t>::max() )
+        return std::numeric_limits<double>::infinity();
+      return _margin * static_cast<double>( _best->cost );
+    }
+
+    // true if a measurement of "total_repetitions" repetitions, whose first "repetitions" repetitions cost "partial_cost" on
+    // average, is to be stopped
+    bool stop( double partial_cost, size_t repetitions, size_t total_repetitions ) const
+    {
+      if( repetitions < _min_repetitions || repetitions >= total_repetitions || partial_cost <= limit() )
+        return false;
+
+      report_stop();
+      return true;
+    }
+
+    // cost of a stopped measurement whose repetitions so far cost "partial_cost": its actual cost is only known to exceed the limit
+    cost_t stopped_cost( cost_t partial_cost ) const
+    {
+      return std::max( partial_cost, static_cast<cost_t>( limit() ) );
+    }
+
+    // reports the cost of a complete (i.e., not stopped) measurement
+    void report( cost_t cost ) const
+    {
+      std::lock_guard<std::mutex> lock( _best->mutex );
+      if( cost < _best->cost )
+        _best->cost = cost;
+    }
+
+    // reports a measurement that was stopped by the cost function itself (e.g., a killed script)
+    void report_stop() const
+    {
+      std::lock_guard<std::mutex> lock( _best->mutex );
+      ++_best->number_of_stopped_measurements;
+    }
+
+    size_t number_of_stopped_measurements() const
+    {
+      std::lock_guard<std::mutex> lock( _best->mutex );
+      return _best->number_of_stopped_measurements;
+    }
+
+  private:
+    struct best_measurement
+    {
+      std::mutex mutex;
+      cost_t     cost                           = std::numeric_limits<cost_t>::max();
+      size_t     number_of_stopped_measurements = 0;
+    };
+
+    double                              _margin;
+    size_t                              _min_repetitions;
+    std::shared_ptr<best_measurement>   _best;
+};
+
+// stops a measurement once the cost of at least "min_repetitions" repetitions exceeds "margin" times the best cost so far
+// (e.g., "1.1": the configuration is 10% slower than the best one)
+inline racing_class racing( double margin = 1.0, size_t min_repetitions = 1 )
+{
+  if( margin < 1.0 )
+    throw std::runtime_error( "margin of racing must be at least 1" );
+  return racing_class( margin, min_repetitions );
+}
+
+// measurements are never stopped
+inline racing_class no_racing()
+{
+  return racing_class( std::numeric_limits<double>::infinity(), 0 );
+}
+
+} // namespace "atf"
+
+#endif /* racing_h */
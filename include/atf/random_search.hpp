@@ -4,8 +4,11 @@
 #include <random>
 #include <chrono>
 #include <fstream>
+#include <climits>
+#include <algorithm>
 
 #include "search_technique_1d.hpp"
+#include "detail/technique_state.hpp"
 
 namespace atf
 {
@@ -16,24 +19,62 @@ class random_search : public search_technique_1d
     void initialize( big_int search_space_size ) override
     {
       _search_space_size = search_space_size;
+
+      // indices of search spaces whose size fits into 64 bits are drawn natively
+      _native = search_space_size <= big_int( static_cast<unsigned long long>( ULLONG_MAX ) );
+      if( _native )
+        _distribution = std::uniform_int_distribution<unsigned long long>( 0, static_cast<unsigned long long>( search_space_size ) - 1 );
     }
 
 
+    // "_batch_size" random indices (fewer if indices are drawn repeatedly)
     std::set<index> get_next_indices() override
     {
-      return { big_int(0, _search_space_size) };
+      std::set<index> indices;
+      for( size_t i = 0 ; i < _batch_size ; ++i )
+      {
+        if( _native )
+          indices.emplace( big_int( _distribution( _random_engine ) ) );
+        else
+          indices.emplace( big_int(0, _search_space_size) );
+      }
+      return indices;
     }
 
 
-    void report_costs( const std::map<index, cost_t>& costs ) override
+    void report_costs( const std::map<index, cost_t>& /* costs */ ) override
     {}
 
 
+    void set_batch_size( size_t batch_size ) override
+    {
+      _batch_size = std::max( batch_size, size_t( 1 ) );
+    }
+
+
     void finalize() override
     {}
 
+
+    void save_state( std::ostream& out ) const override
+    {
+      detail::save_value( out, _random_engine );
+      detail::save_value( out, _distribution );
+    }
+
+
+    void load_state( std::istream& in ) override
+    {
+      detail::load_value( in, _random_engine );
+      detail::load_value( in, _distribution );
+    }
+
   private:
-    big_int _search_space_size;
+    big_int                                          _search_space_size;
+    bool                                             _native = false;
+    std::mt19937_64                                  _random_engine{ std::random_device()() };
+    std::uniform_int_distribution<unsigned long long> _distribution;
+    size_t                                           _batch_size = 1;
 };
 
 } // namespace "atf"
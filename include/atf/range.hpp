@@ -13,6 +13,22 @@
 namespace atf
 {
 
+namespace detail
+{
+
+// generator of intervals without a generator; lets TPs recognize ranges of plain integers
+struct identity
+{
+  template< typename T >
+  T operator()( T i ) const
+  {
+    return i;
+  }
+};
+
+} // namespace "detail"
+
+
 class range
 {
   public:
@@ -68,6 +84,21 @@ class interval_class : public range
       return _generator( elem );
     }
   
+    T_in first() const
+    {
+      return _begin;
+    }
+
+    T_in last() const
+    {
+      return _end;
+    }
+
+    T_in step_size() const
+    {
+      return _step_size;
+    }
+  
   private:
     T_in     _begin;
     T_in     _end;
@@ -91,7 +122,7 @@ auto interval( T_in begin, T_in end, T_in step_size, callable generator )
 template< typename T_in >
 auto interval( T_in begin = std::numeric_limits<T_in>::min(), T_in end = std::numeric_limits<T_in>::max() - static_cast<T_in>( 1 ), T_in step_size = static_cast<T_in>( 1 ) )
 {
-  return interval<T_in>( begin, end, step_size, []( T_in i ){ return i; } );
+  return interval<T_in>( begin, end, step_size, detail::identity() );
 }
 
 // intervall with: begin, end, generator
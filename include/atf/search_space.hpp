@@ -9,6 +9,7 @@
 
 #include "tp_value_node.hpp"
 #include "tp_value.hpp"
+#include "flat_configuration.hpp"
 #include "big_int.hpp"
 
 namespace atf
@@ -28,6 +29,13 @@ class search_space
     virtual configuration get_configuration( const coordinates& indices ) const = 0;
     virtual configuration get_configuration( const std::vector<size_t>& indices ) const = 0;
 
+    virtual void get_configuration( const big_int& index,                flat_configuration& config ) const = 0;
+    virtual void get_configuration( const coordinates& indices,          flat_configuration& config ) const = 0;
+    virtual void get_configuration( const std::vector<size_t>& indices, flat_configuration& config ) const = 0;
+
+    // canonical index of the configuration selected by coordinates: coordinates selecting the same configuration have the same index
+    virtual big_int index_of( const coordinates& indices ) const = 0;
+
     virtual size_t num_params() const = 0;
 
     virtual size_t max_childs( size_t layer ) const = 0;
@@ -0,0 +1,528 @@
+
+#ifndef search_space_dag_h
+#define search_space_dag_h
+
+#include <iostream>
+#include <assert.h>
+
+#include <vector>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+#include "tp_value.hpp"
+#include "search_space.hpp"
+#include "flat_configuration.hpp"
+#include "search_space_tree.hpp"
+#include "detail/index_strides.hpp"
+
+namespace atf
+{
+
+// Tree of a TP group compressed into a DAG: identical subtrees (same TP values in the same order) are stored once.
+// Layer "0" holds the root, layer "l" the unique subtrees below the group's l-th TP; each node stores the number of
+// leafs of its subtree, and each edge the number of leafs of the preceding siblings' subtrees, such that leafs can be
+// resolved by descending from the root.
+class dag_tree
+{
+  public:
+    struct layer
+    {
+      void*                                 tp_value_ptr = nullptr;
+      std::vector< value_type >             values;        // value dictionary of the layer's TP
+      std::vector< std::uint32_t >          node_values;   // per node: index in "values"
+      std::vector< size_t >                 num_leafs;     // per node: number of leafs of the node's subtree
+      std::vector< size_t >                 childs_begin;  // per node + 1: edges of node "i" are [ childs_begin[i], childs_begin[i+1] )
+      std::vector< size_t >                 childs;        // per edge: index of the child node in the next layer
+      std::vector< size_t >                 child_offsets; // per edge: number of leafs of the preceding siblings' subtrees
+    };
+
+    // ctors
+    dag_tree()
+      : _layers()
+    {}
+
+    explicit dag_tree( const Tree& tree )
+      : _layers( tree.num_leafs() == 0 ? 1 : tree.num_params() + 1 )
+    {
+      for( auto& layer : _layers )
+        layer.childs_begin.emplace_back( 0 );
+
+      std::vector< std::map< value_type, std::uint32_t > >                             value_ids( _layers.size() );
+      std::vector< std::map< std::pair< std::uint32_t, std::vector<size_t> >, size_t > > node_ids( _layers.size() );
+      intern( tree.root(), 0, value_ids, node_ids );
+    }
+
+    dag_tree(       dag_tree&& other ) = default;
+    dag_tree( const dag_tree&  other ) = default;
+
+
+    size_t num_leafs() const
+    {
+      return _layers.front().num_leafs.front();
+    }
+
+
+    big_int num_configs() const
+    {
+      return num_leafs();
+    }
+
+
+    size_t num_params() const
+    {
+      return _layers.size() - 1;
+    }
+
+
+    size_t num_nodes( size_t l ) const
+    {
+      return _layers[ l ].node_values.size();
+    }
+
+
+    size_t num_childs( size_t l, size_t node ) const
+    {
+      return _layers[ l ].childs_begin[ node + 1 ] - _layers[ l ].childs_begin[ node ];
+    }
+
+
+    // index of the "i"-th child (in layer "l + 1") of node "node" in layer "l"
+    size_t child( size_t l, size_t node, size_t i ) const
+    {
+      assert( i < num_childs( l, node ) );
+
+      return _layers[ l ].childs[ _layers[ l ].childs_begin[ node ] + i ];
+    }
+
+
+    // number of leafs of the subtrees of the childs before the "i"-th child of node "node" in layer "l"
+    size_t child_offset( size_t l, size_t node, size_t i ) const
+    {
+      assert( i < num_childs( l, node ) );
+
+      return _layers[ l ].child_offsets[ _layers[ l ].childs_begin[ node ] + i ];
+    }
+
+
+    // node reached from the root by successively taking the childs "indices"
+    size_t child( const std::vector<size_t>& indices ) const
+    {
+      size_t node = 0;
+      for( size_t l = 0 ; l < indices.size() ; ++l )
+        node = child( l, node, indices[ l ] );
+
+      return node;
+    }
+
+
+    // maximal number of childs for a node in the layer "layer". root has layer "0".
+    size_t max_childs( size_t layer ) const
+    {
+      size_t max_childs = 0;
+      for( size_t node = 0 ; node < num_nodes( layer ) ; ++node )
+        max_childs = std::max( max_childs, num_childs( layer, node ) );
+
+      return max_childs;
+    }
+
+
+    const value_type& value_of( size_t l, size_t node ) const
+    {
+      const auto& layer = _layers[ l ];
+      return layer.values[ layer.node_values[ node ] ];
+    }
+
+
+    void* tp_value_ptr_of( size_t l ) const
+    {
+      return _layers[ l ].tp_value_ptr;
+    }
+
+
+    tp_value tp_value_of( size_t l, size_t node ) const
+    {
+      return tp_value( value_of( l, node ), tp_value_ptr_of( l ) );
+    }
+
+
+    // calls "f( l, node )" for the nodes on the path to the "i"-th leaf (layers "1" to "num_params()")
+    template< typename callable >
+    void path_of_leaf( size_t i, callable&& f ) const
+    {
+      assert( i < num_leafs() );
+
+      size_t node = 0;
+      for( size_t l = 0 ; l + 1 < _layers.size() ; ++l )
+      {
+        const auto& layer = _layers[ l ];
+        auto begin = layer.child_offsets.begin() + layer.childs_begin[ node ];
+        auto end   = layer.child_offsets.begin() + layer.childs_begin[ node + 1 ];
+        auto it    = std::upper_bound( begin, end, i ) - 1;
+
+        i   -= *it;
+        node = layer.childs[ std::distance( layer.child_offsets.begin(), it ) ];
+        f( l + 1, node );
+      }
+
+      assert( i == 0 );
+    }
+
+
+    size_t memory_usage() const
+    {
+      size_t bytes = sizeof( *this );
+      for( const auto& layer : _layers )
+        bytes += sizeof( layer ) + layer.values.capacity()        * sizeof( value_type )
+                                 + layer.node_values.capacity()   * sizeof( std::uint32_t )
+                                 + layer.num_leafs.capacity()     * sizeof( size_t )
+                                 + layer.childs_begin.capacity()  * sizeof( size_t )
+                                 + layer.childs.capacity()        * sizeof( size_t )
+                                 + layer.child_offsets.capacity() * sizeof( size_t );
+      return bytes;
+    }
+
+  private:
+    std::vector< layer > _layers;
+
+    // returns the index of the node in layer "l" that is identical to the subtree of "tree_node"
+    size_t intern( const tp_value_node&                                                               tree_node,
+                   size_t                                                                             l,
+                   std::vector< std::map< value_type, std::uint32_t > >&                              value_ids,
+                   std::vector< std::map< std::pair< std::uint32_t, std::vector<size_t> >, size_t > >& node_ids )
+    {
+      auto& layer = _layers[ l ];
+
+      std::vector< size_t > childs;
+      if( l + 1 < _layers.size() )
+        for( size_t i = 0 ; i < tree_node.num_childs() ; ++i )
+          childs.emplace_back( intern( tree_node.child( i ), l + 1, value_ids, node_ids ) );
+
+      auto value_id = value_ids[ l ].emplace( tree_node.value(), static_cast<std::uint32_t>( layer.values.size() ) );
+      if( value_id.second )
+      {
+        layer.values.emplace_back( tree_node.value() );
+        layer.tp_value_ptr = tree_node.tp_value_ptr();
+      }
+
+      auto node_id = node_ids[ l ].emplace( std::make_pair( value_id.first->second, childs ), layer.node_values.size() );
+      if( !node_id.second )
+        return node_id.first->second;
+
+      // new unique subtree
+      const bool is_leaf = l + 1 == _layers.size() && l > 0;
+      size_t num_leafs = is_leaf ? 1 : 0;
+      for( const auto& child : childs )
+      {
+        layer.childs.emplace_back( child );
+        layer.child_offsets.emplace_back( num_leafs );
+        num_leafs += _layers[ l + 1 ].num_leafs[ child ];
+      }
+      layer.node_values.emplace_back( value_id.first->second );
+      layer.num_leafs.emplace_back( num_leafs );
+      layer.childs_begin.emplace_back( layer.childs.size() );
+
+      return node_id.first->second;
+    }
+};
+
+
+
+// search space whose trees are compressed into DAGs after generation ("compress()")
+class search_space_dag : public search_space
+{
+  public:
+    using tree_type = Tree;
+
+    search_space_dag()
+      : _trees(), _dags(), _tp_names(), _index_strides()
+    {}
+
+    search_space_dag( const search_space_dag&  other ) = default;
+    search_space_dag(       search_space_dag&& other ) = default;
+
+    big_int num_configs() const
+    {
+      if( _index_strides.num_trees() == _dags.size() )
+        return _index_strides.num_configs();
+
+      big_int num_configs = 1;
+
+      for( const auto& dag : _dags )
+        num_configs = num_configs * dag.num_configs();
+
+      return num_configs;
+    }
+
+
+    void append_new_trees( size_t num ) // as "friend"
+    {
+      for( size_t i = 0 ; i < num ; ++i )
+        _trees.emplace_back( std::make_shared<Tree>() );
+    }
+
+    Tree& tree( size_t tree_id )  // as "friend"
+    {
+      return *_trees[ tree_id ];
+    }
+
+    void add_name( const std::string& name )
+    {
+      _tp_names.emplace_back( name );
+    }
+
+
+    // compresses the generated trees into DAGs and releases the trees
+    void compress()
+    {
+      for( size_t tree_id = _dags.size() ; tree_id < _trees.size() ; ++tree_id )
+      {
+        _dags.emplace_back( *_trees[ tree_id ] );
+        _trees[ tree_id ].reset();
+      }
+    }
+
+
+    // precomputes the strides of the DAGs in the index space; called after compression
+    void update_index_strides()
+    {
+      std::vector< size_t > num_leafs;
+      for( const auto& dag : _dags )
+        num_leafs.emplace_back( dag.num_leafs() );
+
+      _index_strides.compute( num_leafs );
+    }
+
+
+    configuration operator[]( const big_int& index ) const {
+        return get_configuration( index );
+    }
+
+
+    configuration get_configuration( const big_int& index ) const
+    {
+      configuration config;
+      fill_configuration( index, config );
+      return config;
+    }
+
+
+    configuration get_configuration( const coordinates& indices ) const
+    {
+      configuration config;
+      fill_configuration( indices, config );
+      return config;
+    }
+
+
+    configuration get_configuration( const std::vector<size_t>& indices ) const
+    {
+      configuration config;
+      fill_configuration( indices, config );
+      return config;
+    }
+
+
+    // decode into a reused configuration
+    void get_configuration( const big_int& index, flat_configuration& config ) const
+    {
+      config.reset( _tp_names );
+      fill_configuration( index, config );
+    }
+
+
+    void get_configuration( const coordinates& indices, flat_configuration& config ) const
+    {
+      config.reset( _tp_names );
+      fill_configuration( indices, config );
+    }
+
+
+    void get_configuration( const std::vector<size_t>& indices, flat_configuration& config ) const
+    {
+      config.reset( _tp_names );
+      fill_configuration( indices, config );
+    }
+
+
+    // index "i" with "get_configuration( i ) == get_configuration( indices )"; a leaf's id in its DAG is the sum of the child offsets on its path
+    big_int index_of( const coordinates& indices ) const
+    {
+      assert( indices.size() == this->num_params() );
+      assert( _index_strides.num_trees() == _dags.size() );
+      if (!atf::valid_coordinates(indices)) {
+        throw std::runtime_error("search space coordinate is out of bounds (0.0,1.0]");
+      }
+
+      std::vector< size_t > leaf_ids;
+      size_t i_global = 0;
+      for( const auto& dag : _dags )
+      {
+        size_t node    = 0;
+        size_t leaf_id = 0;
+        for( size_t l = 0 ; l < dag.num_params() ; ++l, ++i_global )
+        {
+          const size_t i = std::ceil( indices[ i_global ] * dag.num_childs( l, node ) ) - 1;
+          leaf_id += dag.child_offset( l, node, i );
+          node     = dag.child( l, node, i );
+        }
+        leaf_ids.emplace_back( leaf_id );
+      }
+
+      return _index_strides.encode( leaf_ids );
+    }
+
+
+    // the number of TPs, i.e. the tree depth
+    size_t num_params() const
+    {
+      size_t num_params_of_all_trees = 0;
+
+      for( const auto& dag : _dags )
+        num_params_of_all_trees += dag.num_params();
+
+      return num_params_of_all_trees;
+    }
+
+
+    size_t max_childs( size_t layer ) const
+    {
+      assert( layer < this->num_params() );
+
+      for( const auto& dag : _dags )
+      {
+        if( layer < dag.num_params() )
+          return dag.max_childs( layer );
+        else
+          layer -= dag.num_params(); // go to the next config_tree generated by "G(...)"
+      }
+
+      assert( false ); // should never be reached
+
+      return 0;
+    }
+
+
+    size_t max_childs_of_node( std::vector<size_t>& indices ) const {
+      assert( indices.size() < this->num_params() );
+      size_t tree_index = 0;
+
+      while( indices.size() >= _dags[ tree_index ].num_params() )
+        indices.erase( indices.begin(), indices.begin() + _dags[ tree_index++ ].num_params() );
+
+      const auto& dag = _dags[ tree_index ];
+      return dag.num_childs( indices.size(), dag.child( indices ) );
+    }
+
+
+    const std::vector< std::string >& names() const
+    {
+      return _tp_names;
+    }
+
+
+    const std::string& name( size_t i ) const
+    {
+      return _tp_names[ i ];
+    }
+
+
+    size_t num_trees() const // as "friend"
+    {
+      return _trees.size();
+    }
+
+
+    const std::vector< dag_tree >& dags() const
+    {
+      return _dags;
+    }
+
+
+    // number of heap allocated bytes of the DAGs
+    size_t memory_usage() const
+    {
+      size_t bytes = 0;
+      for( const auto& dag : _dags )
+        bytes += dag.memory_usage();
+
+      return bytes;
+    }
+
+  private:
+    template< typename config_t >
+    void fill_configuration( const big_int& index, config_t& config ) const
+    {
+      assert( _index_strides.num_trees() == _dags.size() );
+      if (index > _index_strides.num_configs()) {
+        throw std::runtime_error("search space index is out of bounds");
+      }
+
+      size_t first_param = 0;
+      _index_strides.decode( index, [&]( size_t tree_id, size_t leaf_id ) {
+        const auto& dag = _dags[ tree_id ];
+        dag.path_of_leaf( leaf_id, [&]( size_t l, size_t node ) {
+          detail::store_tp_value( config, _tp_names, first_param + l - 1, dag.value_of( l, node ), dag.tp_value_ptr_of( l ) );
+        } );
+        first_param += dag.num_params();
+      } );
+    }
+
+
+    template< typename config_t >
+    void fill_configuration( const coordinates& indices, config_t& config ) const
+    {
+      assert( indices.size()   == this->num_params() );
+      assert( _tp_names.size() == this->num_params() );
+      if (!atf::valid_coordinates(indices)) {
+        throw std::runtime_error("search space coordinate is out of bounds (0.0,1.0]");
+      }
+
+      size_t i_global = 0;
+      for( const auto& dag : _dags )
+      {
+        size_t node = 0;
+        for( size_t l = 0 ; l < dag.num_params() ; ++l, ++i_global )
+        {
+          node = dag.child( l, node, std::ceil( indices[ i_global ] * dag.num_childs( l, node ) ) - 1 );
+          detail::store_tp_value( config, _tp_names, i_global, dag.value_of( l + 1, node ), dag.tp_value_ptr_of( l + 1 ) );
+        }
+      }
+
+      assert( i_global == config.size() );
+    }
+
+
+    template< typename config_t >
+    void fill_configuration( const std::vector<size_t>& indices, config_t& config ) const
+    {
+      assert( indices.size()   == this->num_params() );
+      assert( _tp_names.size() == this->num_params() );
+
+      size_t i_global = 0;
+      for( const auto& dag : _dags )
+      {
+        size_t node = 0;
+        for( size_t l = 0 ; l < dag.num_params() ; ++l, ++i_global )
+        {
+          node = dag.child( l, node, indices[ i_global ] );
+          detail::store_tp_value( config, _tp_names, i_global, dag.value_of( l + 1, node ), dag.tp_value_ptr_of( l + 1 ) );
+        }
+      }
+
+      assert( i_global == config.size() );
+    }
+
+    std::vector< std::shared_ptr<Tree> > _trees; // generated trees, released by "compress()"
+    std::vector< dag_tree >              _dags;
+    std::vector< std::string >           _tp_names;
+    detail::index_strides                _index_strides;
+};
+
+
+} // namespace "atf"
+
+
+#endif /* search_space_dag_h */
@@ -0,0 +1,893 @@
+
+#ifndef search_space_flat_h
+#define search_space_flat_h
+
+#include <iostream>
+#include <assert.h>
+
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <cstdio>
+
+#include "tp_value.hpp"
+#include "search_space.hpp"
+#include "flat_configuration.hpp"
+#include "detail/search_space_file.hpp"
+#include "detail/index_strides.hpp"
+
+namespace atf
+{
+
+namespace detail
+{
+
+// array that either owns its elements or is a read-only view into a mapped search space file; a view is copied on first modification
+template< typename T >
+class flat_array
+{
+  public:
+    flat_array()
+      : _vector(), _data( nullptr ), _size( 0 ), _is_view( false )
+    {}
+
+    flat_array( const T* data, size_t size )
+      : _vector(), _data( data ), _size( size ), _is_view( true )
+    {}
+
+    flat_array( const flat_array& other )
+      : _vector( other._vector ), _data( other._is_view ? other._data : _vector.data() ), _size( other._size ), _is_view( other._is_view )
+    {}
+
+    flat_array( flat_array&& other )
+      : _vector( std::move( other._vector ) ), _data( other._is_view ? other._data : _vector.data() ), _size( other._size ), _is_view( other._is_view )
+    {
+      other.clear();
+    }
+
+    flat_array& operator=( flat_array other )
+    {
+      _vector.swap( other._vector );
+      _is_view = other._is_view;
+      _size    = other._size;
+      _data    = _is_view ? other._data : _vector.data();
+      return *this;
+    }
+
+    size_t size() const
+    {
+      return _size;
+    }
+
+    bool empty() const
+    {
+      return _size == 0;
+    }
+
+    const T* data() const
+    {
+      return _data;
+    }
+
+    const T& operator[]( size_t i ) const
+    {
+      return _data[ i ];
+    }
+
+    const T& front() const
+    {
+      return _data[ 0 ];
+    }
+
+    const T& back() const
+    {
+      return _data[ _size - 1 ];
+    }
+
+    T& back()
+    {
+      own();
+      return _vector.back();
+    }
+
+    void emplace_back( const T& value )
+    {
+      own();
+      _vector.emplace_back( value );
+      sync();
+    }
+
+    void resize( size_t size )
+    {
+      own();
+      _vector.resize( size );
+      sync();
+    }
+
+    void clear()
+    {
+      _vector.clear();
+      _is_view = false;
+      sync();
+    }
+
+    // number of heap allocated bytes
+    size_t memory_usage() const
+    {
+      return _vector.capacity() * sizeof( T );
+    }
+
+  private:
+    std::vector<T> _vector;
+    const T*       _data;
+    size_t         _size;
+    bool           _is_view;
+
+    void own()
+    {
+      if( _is_view )
+      {
+        _vector.assign( _data, _data + _size );
+        _is_view = false;
+        sync();
+      }
+    }
+
+    void sync()
+    {
+      _data = _vector.data();
+      _size = _vector.size();
+    }
+};
+
+} // namespace "detail"
+
+
+// Tree of a TP group, stored level-ordered in contiguous arrays: layer "l" holds the nodes of the group's l-th TP
+// in the order of their paths; the childs of a node are a contiguous index range (CSR style) of the next layer.
+class flat_tree
+{
+  public:
+    struct layer
+    {
+      void*                                tp_value_ptr = nullptr;
+      std::vector< value_type >            values;        // value dictionary of the layer's TP
+      std::map< value_type, std::uint32_t > value_ids;     // value -> index in "values"
+      detail::flat_array< std::uint32_t >  node_values;   // per node: index in "values"
+      detail::flat_array< size_t >         parents;       // per node: index of the parent node in the previous layer
+      detail::flat_array< size_t >         childs_begin;  // per node + 1: childs of node "i" are [ childs_begin[i], childs_begin[i+1] ) in the next layer
+    };
+
+    // ctors
+    flat_tree()
+      : _layers()
+    {}
+
+    flat_tree(       flat_tree&& other ) = default;
+    flat_tree( const flat_tree&  other ) = default;
+
+
+    big_int num_configs() const
+    {
+      return num_leafs();
+    }
+
+
+    size_t num_leafs() const
+    {
+      return _layers.empty() ? 0 : _layers.back().node_values.size();
+    }
+
+
+    size_t depth() const
+    {
+      return _layers.size();
+    }
+
+
+    size_t num_params() const
+    {
+      return _layers.size();
+    }
+
+
+    template< typename... Ts >
+    void insert( Ts... params )
+    {
+      if( _layers.empty() )
+        _layers.resize( sizeof...( params ) );
+      assert( _layers.size() == sizeof...( params ) );
+
+      insert_values( 0, false, params... );
+    }
+
+
+    // inserts a path of (value, TP value pointer) pairs determined at runtime
+    void insert_path( const std::vector< std::pair<value_type, void*> >& path )
+    {
+      if( _layers.empty() )
+        _layers.resize( path.size() );
+      assert( _layers.size() == path.size() );
+
+      bool diverged = false;
+      for( size_t l = 0 ; l < path.size() ; ++l )
+        diverged = insert_value( l, diverged, path[ l ].first, path[ l ].second, l + 1 < path.size() );
+    }
+
+
+    // appends the paths of "subtree" behind the paths of this tree (used to merge subtrees generated in parallel)
+    void append( flat_tree&& subtree )
+    {
+      if( subtree._layers.empty() )
+        return;
+      if( _layers.empty() )
+      {
+        *this = std::move( subtree );
+        return;
+      }
+      assert( _layers.size() == subtree._layers.size() );
+
+      // as in "insert", the first inner node of a subtree layer is merged with the last node of the layer if their paths are equal
+      std::vector< size_t > shifts( _layers.size() );
+      bool merges = true;
+      for( size_t l = 0 ; l < _layers.size() ; ++l )
+      {
+        auto&       layer     = _layers[ l ];
+        const auto& sub_layer = subtree._layers[ l ];
+
+        merges = merges && l + 1 < _layers.size() && !layer.node_values.empty()
+                        && !( layer.values[ layer.node_values.back() ] != sub_layer.values[ sub_layer.node_values.front() ] );
+        shifts[ l ] = layer.node_values.size() - ( merges ? 1 : 0 );
+      }
+
+      for( size_t l = 0 ; l < _layers.size() ; ++l )
+      {
+        auto&       layer     = _layers[ l ];
+        const auto& sub_layer = subtree._layers[ l ];
+        const bool  is_inner  = l + 1 < _layers.size();
+        const size_t first    = layer.node_values.size() - shifts[ l ]; // 1 iff the subtree's first node is merged
+
+        if( layer.tp_value_ptr == nullptr )
+          layer.tp_value_ptr = sub_layer.tp_value_ptr;
+
+        for( size_t i = first ; i < sub_layer.node_values.size() ; ++i )
+        {
+          layer.node_values.emplace_back( value_id( layer, sub_layer.values[ sub_layer.node_values[ i ] ] ) );
+          layer.parents.emplace_back( l == 0 ? 0 : shifts[ l - 1 ] + sub_layer.parents[ i ] );
+        }
+
+        if( is_inner )
+        {
+          layer.childs_begin.resize( shifts[ l ] + 1 );
+          for( size_t i = 0 ; i < sub_layer.node_values.size() ; ++i )
+            layer.childs_begin.emplace_back( shifts[ l + 1 ] + sub_layer.childs_begin[ i + 1 ] );
+        }
+      }
+
+      subtree._layers.clear();
+    }
+
+
+    const layer& get_layer( size_t l ) const
+    {
+      return _layers[ l ];
+    }
+
+
+    // number of childs of node "node" in layer "l"; "l == -1" denotes the root
+    size_t num_childs( int l, size_t node ) const
+    {
+      if( l < 0 )
+        return _layers.front().node_values.size();
+
+      const auto& childs_begin = _layers[ l ].childs_begin;
+      return childs_begin[ node + 1 ] - childs_begin[ node ];
+    }
+
+
+    // index of the "i"-th child of node "node" in layer "l"; "l == -1" denotes the root
+    size_t child( int l, size_t node, size_t i ) const
+    {
+      assert( i < num_childs( l, node ) );
+
+      if( l < 0 )
+        return i;
+
+      return _layers[ l ].childs_begin[ node ] + i;
+    }
+
+
+    // node reached from the root by successively taking the childs "indices"
+    size_t child( const std::vector<size_t>& indices ) const
+    {
+      size_t node = 0;
+      for( size_t l = 0 ; l < indices.size() ; ++l )
+        node = child( static_cast<int>( l ) - 1, node, indices[ l ] );
+
+      return node;
+    }
+
+
+    // maximal number of childs for a node in the layer "layer". root has layer "0".
+    size_t max_childs( size_t layer ) const
+    {
+      if( layer == 0 )
+        return _layers.front().node_values.size();
+
+      const auto& childs_begin = _layers[ layer - 1 ].childs_begin;
+      size_t max_childs = 0;
+      for( size_t i = 0 ; i + 1 < childs_begin.size() ; ++i )
+        max_childs = std::max( max_childs, childs_begin[ i + 1 ] - childs_begin[ i ] );
+
+      return max_childs;
+    }
+
+
+    const value_type& value_of( size_t l, size_t node ) const
+    {
+      const auto& layer = _layers[ l ];
+      return layer.values[ layer.node_values[ node ] ];
+    }
+
+
+    void* tp_value_ptr_of( size_t l ) const
+    {
+      return _layers[ l ].tp_value_ptr;
+    }
+
+
+    tp_value tp_value_of( size_t l, size_t node ) const
+    {
+      return tp_value( value_of( l, node ), tp_value_ptr_of( l ) );
+    }
+
+
+    size_t memory_usage() const
+    {
+      size_t bytes = sizeof( *this );
+      for( const auto& layer : _layers )
+        bytes += sizeof( layer ) + layer.values.capacity() * sizeof( value_type )
+                                 + layer.node_values.memory_usage()
+                                 + layer.parents.memory_usage()
+                                 + layer.childs_begin.memory_usage();
+      return bytes;
+    }
+
+
+    void set_tp_value_ptr( size_t l, void* tp_value_ptr )
+    {
+      _layers[ l ].tp_value_ptr = tp_value_ptr;
+    }
+
+
+    void save( detail::search_space_file_writer& out ) const
+    {
+      out.write_uint64( _layers.size() );
+      for( const auto& layer : _layers )
+      {
+        out.write_uint64( layer.values.size() );
+        for( const auto& value : layer.values )
+          out.write_value( value );
+
+        out.write_uint64( layer.node_values.size() );
+        out.write_array( layer.node_values.data(), layer.node_values.size() );
+        out.write_array( layer.parents.data(), layer.parents.size() );
+        out.write_uint64( layer.childs_begin.size() );
+        out.write_array( layer.childs_begin.data(), layer.childs_begin.size() );
+      }
+    }
+
+
+    // the node arrays of the loaded tree point into the mapped file
+    static flat_tree load( detail::search_space_file_reader& in )
+    {
+      flat_tree tree;
+      tree._layers.resize( in.read_size() );
+      for( auto& layer : tree._layers )
+      {
+        auto num_values = in.read_size();
+        for( size_t i = 0 ; i < num_values ; ++i )
+          value_id( layer, in.read_value() );
+
+        auto num_nodes = in.read_size();
+        layer.node_values = detail::flat_array<std::uint32_t>( in.read_array<std::uint32_t>( num_nodes ), num_nodes );
+        layer.parents     = detail::flat_array<size_t>( in.read_array<size_t>( num_nodes ), num_nodes );
+        auto num_childs_begin = in.read_size();
+        layer.childs_begin = detail::flat_array<size_t>( in.read_array<size_t>( num_childs_begin ), num_childs_begin );
+      }
+      tree.check_layers();
+
+      return tree;
+    }
+
+
+    flat_tree& operator=( flat_tree&& other ) = default;
+
+  private:
+    std::vector< layer > _layers;
+
+    // The node arrays of a loaded tree are used without bounds checks: node values have to index the layer's values, parents the
+    // nodes of the previous layer, and the childs of each inner node have to be the range of nodes of the next layer whose parent
+    // it is (which makes "childs_begin" monotone).
+    void check_layers() const
+    {
+      for( size_t l = 0 ; l < _layers.size() ; ++l )
+      {
+        const auto&  layer     = _layers[ l ];
+        const size_t num_nodes = layer.node_values.size();
+        for( size_t i = 0 ; i < num_nodes ; ++i )
+        {
+          const bool parent_exists = l == 0 ? layer.parents[ i ] == 0 : layer.parents[ i ] < _layers[ l - 1 ].node_values.size();
+          if( layer.node_values[ i ] >= layer.values.size() || !parent_exists )
+            throw detail::corrupt_search_space_file( "search space file is corrupt" );
+        }
+
+        const bool is_inner = l + 1 < _layers.size();
+        if( !is_inner || num_nodes == 0 )
+        {
+          if( !layer.childs_begin.empty() || ( is_inner && !_layers[ l + 1 ].node_values.empty() ) )
+            throw detail::corrupt_search_space_file( "search space file is corrupt" );
+          continue;
+        }
+
+        const auto& childs = _layers[ l + 1 ];
+        if( layer.childs_begin.size() != num_nodes + 1 || layer.childs_begin[ 0 ] != 0 || layer.childs_begin[ num_nodes ] != childs.node_values.size() )
+          throw detail::corrupt_search_space_file( "search space file is corrupt" );
+        for( size_t i = 0 ; i < childs.node_values.size() ; ++i )
+        {
+          const size_t parent = childs.parents[ i ];
+          if( parent >= num_nodes || i < layer.childs_begin[ parent ] || i >= layer.childs_begin[ parent + 1 ] )
+            throw detail::corrupt_search_space_file( "search space file is corrupt" );
+        }
+        for( size_t i = 0 ; i < num_nodes ; ++i )
+          if( layer.childs_begin[ i ] > layer.childs_begin[ i + 1 ] )
+            throw detail::corrupt_search_space_file( "search space file is corrupt" );
+      }
+    }
+
+    static std::uint32_t value_id( layer& tp_layer, const value_type& value )
+    {
+      auto it = tp_layer.value_ids.find( value );
+      if( it != tp_layer.value_ids.end() )
+        return it->second;
+
+      auto id = static_cast<std::uint32_t>( tp_layer.values.size() );
+      tp_layer.values.emplace_back( value );
+      tp_layer.value_ids.emplace( value, id );
+      return id;
+    }
+
+    // a node is created for each value of the path behind the first value that differs from the last inserted path
+    template< typename T, typename... T_rest >
+    void insert_values( size_t l, bool diverged, T fst, T_rest... rest )
+    {
+      diverged = insert_value( l, diverged, value_type( std::get<0>( fst ) ), std::get<1>( fst ), sizeof...( rest ) > 0 );
+      insert_values( l + 1, diverged, rest... );
+    }
+
+    // inserts the value of a path into layer "l"; returns true iff the path has diverged from the previous path
+    bool insert_value( size_t l, bool diverged, const value_type& value, void* tp_value_ptr, bool is_inner )
+    {
+      auto& layer = _layers[ l ];
+      if( layer.tp_value_ptr == nullptr )
+        layer.tp_value_ptr = tp_value_ptr;
+
+      const auto id = value_id( layer, value );
+
+      if( diverged || !is_inner || layer.node_values.empty() || layer.node_values.back() != id )
+      {
+        if( is_inner && layer.childs_begin.empty() )
+          layer.childs_begin.emplace_back( 0 );
+
+        layer.node_values.emplace_back( id );
+        layer.parents.emplace_back( l == 0 ? 0 : _layers[ l - 1 ].node_values.size() - 1 );
+        if( is_inner )
+          layer.childs_begin.emplace_back( layer.childs_begin.back() );
+        if( l > 0 )
+          _layers[ l - 1 ].childs_begin.back() = layer.node_values.size();
+
+        diverged = true;
+      }
+
+      return diverged;
+    }
+
+    void insert_values( size_t, bool )
+    {}
+};
+
+
+
+class search_space_flat : public search_space
+{
+  public:
+    using tree_type = flat_tree;
+
+    search_space_flat()
+      : _trees(), _tp_names(), _file(), _index_strides()
+    {}
+
+    search_space_flat( const search_space_flat&  other ) = default;
+    search_space_flat(       search_space_flat&& other ) = default;
+
+    search_space_flat& operator=( const search_space_flat&  other ) = default;
+    search_space_flat& operator=(       search_space_flat&& other ) = default;
+
+    big_int num_configs() const
+    {
+      if( _index_strides.num_trees() == _trees.size() )
+        return _index_strides.num_configs();
+
+      big_int num_configs = 1;
+
+      for( const auto& tree : _trees )
+        num_configs = num_configs * tree.num_configs();
+
+      return num_configs;
+    }
+
+
+    // precomputes the strides of the trees in the index space; called after generation
+    void update_index_strides()
+    {
+      _index_strides.compute( num_leafs_of_trees() );
+    }
+
+
+    void append_new_trees( size_t num ) // as "friend"
+    {
+      auto old_size = _trees.size();
+      _trees.resize( old_size + num );
+    }
+
+    flat_tree& tree( size_t tree_id )  // as "friend"
+    {
+      return _trees[ tree_id ];
+    }
+
+    void add_name( const std::string& name )
+    {
+      _tp_names.emplace_back( name );
+    }
+
+
+    configuration operator[]( const big_int& index ) const {
+        return get_configuration( index );
+    }
+
+
+    configuration get_configuration( const big_int& index ) const
+    {
+      configuration config;
+      fill_configuration( index, config );
+      return config;
+    }
+
+
+    configuration get_configuration( const coordinates& indices ) const
+    {
+      configuration config;
+      fill_configuration( indices, config );
+      return config;
+    }
+
+
+    configuration get_configuration( const std::vector<size_t>& indices ) const
+    {
+      configuration config;
+      fill_configuration( indices, config );
+      return config;
+    }
+
+
+    // decode into a reused configuration
+    void get_configuration( const big_int& index, flat_configuration& config ) const
+    {
+      config.reset( _tp_names );
+      fill_configuration( index, config );
+    }
+
+
+    void get_configuration( const coordinates& indices, flat_configuration& config ) const
+    {
+      config.reset( _tp_names );
+      fill_configuration( indices, config );
+    }
+
+
+    void get_configuration( const std::vector<size_t>& indices, flat_configuration& config ) const
+    {
+      config.reset( _tp_names );
+      fill_configuration( indices, config );
+    }
+
+
+    // index "i" with "get_configuration( i ) == get_configuration( indices )"; a leaf's id in its tree is its node index in the last layer
+    big_int index_of( const coordinates& indices ) const
+    {
+      assert( indices.size() == this->num_params() );
+      assert( _index_strides.num_trees() == _trees.size() );
+      if (!atf::valid_coordinates(indices)) {
+        throw std::runtime_error("search space coordinate is out of bounds (0.0,1.0]");
+      }
+
+      std::vector< size_t > leaf_ids;
+      size_t i_global = 0;
+      for( const auto& tree : _trees )
+      {
+        size_t node = 0;
+        for( size_t l = 0 ; l < tree.num_params() ; ++l, ++i_global )
+        {
+          auto num_childs = tree.num_childs( static_cast<int>( l ) - 1, node );
+          node = tree.child( static_cast<int>( l ) - 1, node, std::ceil(indices[ i_global ] * num_childs) - 1 );
+        }
+        leaf_ids.emplace_back( node );
+      }
+
+      return _index_strides.encode( leaf_ids );
+    }
+
+
+    // the number of TPs, i.e. the tree depth
+    size_t num_params() const
+    {
+      size_t num_params_of_all_trees = 0;
+
+      for( const auto& tree : _trees )
+        num_params_of_all_trees += tree.num_params();
+
+      return num_params_of_all_trees;
+    }
+
+
+    size_t max_childs( size_t layer ) const
+    {
+      assert( layer < this->num_params() );
+
+      for( const auto& tree : _trees )
+      {
+        if( layer < tree.num_params() )
+          return tree.max_childs( layer );
+        else
+          layer -= tree.num_params(); // go to the next config_tree generated by "G(...)"
+      }
+
+      assert( false ); // should never be reached
+
+      return 0;
+    }
+
+
+    size_t max_childs_of_node( std::vector<size_t>& indices ) const {
+      assert( indices.size() < this->num_params() );
+      size_t tree_index = 0;
+
+      while( indices.size() >= _trees[ tree_index ].num_params() )
+        indices.erase( indices.begin(), indices.begin() + _trees[ tree_index++ ].num_params() );
+
+      const auto& tree = _trees[ tree_index ];
+      return tree.num_childs( static_cast<int>( indices.size() ) - 1, tree.child( indices ) );
+    }
+
+
+    const std::vector< std::string >& names() const
+    {
+      return _tp_names;
+    }
+
+
+    const std::string& name( size_t i ) const
+    {
+      return _tp_names[ i ];
+    }
+
+
+    size_t num_trees() const // as "friend"
+    {
+      return _trees.size();
+    }
+
+    const std::vector<flat_tree>& trees() const
+    {
+      return _trees;
+    }
+
+
+    // number of bytes occupied by the trees
+    size_t memory_usage() const
+    {
+      size_t bytes = 0;
+      for( const auto& tree : _trees )
+        bytes += tree.memory_usage();
+
+      return bytes;
+    }
+
+    // binds the TPs (in order of their names) to the search space, e.g., after loading it from a file
+    void set_tp_value_ptrs( const std::vector<void*>& tp_value_ptrs )
+    {
+      assert( tp_value_ptrs.size() == this->num_params() );
+
+      size_t i_global = 0;
+      for( auto& tree : _trees )
+        for( size_t l = 0 ; l < tree.num_params() ; ++l )
+          tree.set_tp_value_ptr( l, tp_value_ptrs[ i_global++ ] );
+    }
+
+
+    // writes the search space to a binary file that can later be mapped into memory by "load"; "key" identifies the TP definitions;
+    // the file is written under a temporary name and renamed, so that an interrupted run does not leave a partial file behind
+    void save( const std::string& path, std::uint64_t key ) const
+    {
+      const std::string temporary_path = path + ".tmp";
+      {
+        detail::search_space_file_writer out( temporary_path );
+        out.write_string( file_magic() );
+        out.write_uint64( sizeof( size_t ) );
+        out.write_uint64( key );
+
+        out.write_uint64( _tp_names.size() );
+        for( const auto& name : _tp_names )
+          out.write_string( name );
+
+        out.write_uint64( _trees.size() );
+        for( const auto& tree : _trees )
+          tree.save( out );
+
+        if( !out.good() )
+          throw std::runtime_error( "cannot write search space file: " + path );
+      }
+
+      std::remove( path.c_str() ); // "std::rename" does not replace existing files on all platforms
+      if( std::rename( temporary_path.c_str(), path.c_str() ) != 0 )
+        throw std::runtime_error( "cannot write search space file: " + path );
+    }
+
+
+    // maps a search space file written by "save" into memory; returns false if the file does not exist, has a different key,
+    // or is corrupt (the search space is then generated and saved again)
+    bool load( const std::string& path, std::uint64_t key )
+    {
+      if( !std::ifstream( path ).good() )
+        return false;
+
+      auto file = std::make_shared<detail::mapped_file>( path );
+      detail::search_space_file_reader in( *file );
+      std::vector< std::string > tp_names;
+      std::vector< flat_tree >   trees;
+      try
+      {
+        if( in.read_string() != file_magic() || in.read_uint64() != sizeof( size_t ) || in.read_uint64() != key )
+          return false;
+
+        tp_names.resize( in.read_size() );
+        for( auto& name : tp_names )
+          name = in.read_string();
+
+        trees.resize( in.read_size() );
+        for( auto& tree : trees )
+          tree = flat_tree::load( in );
+      }
+      catch( const detail::corrupt_search_space_file& )
+      {
+        return false;
+      }
+
+      size_t num_params = 0;
+      for( const auto& tree : trees )
+        num_params += tree.num_params();
+      if( num_params != tp_names.size() )
+        return false;
+
+      _trees    = std::move( trees );
+      _tp_names = std::move( tp_names );
+      _file     = file;
+      update_index_strides();
+      return true;
+    }
+
+  private:
+    template< typename config_t >
+    void fill_configuration( const big_int& index, config_t& config ) const
+    {
+      // strides are computed here if the trees have changed since the last "update_index_strides()"
+      detail::index_strides current_strides;
+      const detail::index_strides* strides = &_index_strides;
+      if( _index_strides.num_trees() != _trees.size() )
+      {
+        current_strides.compute( num_leafs_of_trees() );
+        strides = &current_strides;
+      }
+
+      if (index > strides->num_configs()) {
+        throw std::runtime_error("search space index is out of bounds");
+      }
+
+      size_t first_param = 0;
+      strides->decode( index, [&]( size_t tree_id, size_t leaf_id ) {
+        const auto& tree = _trees[ tree_id ];
+
+        // go leaf up and insert TP values in config
+        size_t pos  = first_param + tree.num_params() - 1;
+        size_t node = leaf_id;
+        for( int l = static_cast<int>( tree.num_params() ) - 1 ; l >= 0 ; --l )
+        {
+          detail::store_tp_value( config, _tp_names, pos, tree.value_of( l, node ), tree.tp_value_ptr_of( l ) );
+          --pos;
+          node = tree.get_layer( l ).parents[ node ];
+        }
+        first_param += tree.num_params();
+      } );
+    }
+
+
+    template< typename config_t >
+    void fill_configuration( const coordinates& indices, config_t& config ) const
+    {
+      assert( indices.size()   == this->num_params() );
+      assert( _tp_names.size() == this->num_params() );
+      if (!atf::valid_coordinates(indices)) {
+        throw std::runtime_error("search space coordinate is out of bounds (0.0,1.0]");
+      }
+
+      size_t i_global = 0;
+      for( const auto& tree : _trees )
+      {
+        size_t node = 0;
+        for( size_t l = 0 ; l < tree.num_params() ; ++l, ++i_global )
+        {
+          auto num_childs = tree.num_childs( static_cast<int>( l ) - 1, node );
+          node = tree.child( static_cast<int>( l ) - 1, node, std::ceil(indices[ i_global ] * num_childs) - 1 );
+          detail::store_tp_value( config, _tp_names, i_global, tree.value_of( l, node ), tree.tp_value_ptr_of( l ) );
+        }
+      }
+
+      assert( i_global == config.size() );
+    }
+
+
+    template< typename config_t >
+    void fill_configuration( const std::vector<size_t>& indices, config_t& config ) const
+    {
+      assert( indices.size()   == this->num_params() );
+      assert( _tp_names.size() == this->num_params() );
+
+      size_t i_global = 0;
+      for( const auto& tree : _trees )
+      {
+        size_t node = 0;
+        for( size_t l = 0 ; l < tree.num_params() ; ++l, ++i_global )
+        {
+          node = tree.child( static_cast<int>( l ) - 1, node, indices[ i_global ] );
+          detail::store_tp_value( config, _tp_names, i_global, tree.value_of( l, node ), tree.tp_value_ptr_of( l ) );
+        }
+      }
+
+      assert( i_global == config.size() );
+    }
+
+    std::vector< flat_tree >             _trees;
+    std::vector< std::string >           _tp_names;
+    std::shared_ptr<detail::mapped_file> _file; // keeps node arrays of loaded trees alive
+    detail::index_strides                _index_strides;
+
+    std::vector< size_t > num_leafs_of_trees() const
+    {
+      std::vector< size_t > num_leafs;
+      for( const auto& tree : _trees )
+        num_leafs.emplace_back( tree.num_leafs() );
+
+      return num_leafs;
+    }
+
+    static std::string file_magic()
+    {
+      return "ATF search space v1";
+    }
+};
+
+
+} // namespace "atf"
+
+
+#endif /* search_space_flat_h */
@@ -0,0 +1,409 @@
+
+#ifndef search_space_lazy_h
+#define search_space_lazy_h
+
+#include <iostream>
+#include <assert.h>
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cmath>
+
+#include "tp.hpp"
+#include "tp_value.hpp"
+#include "search_space.hpp"
+#include "flat_configuration.hpp"
+
+namespace atf
+{
+
+// Tree of a TP group whose nodes are generated on demand: the childs of a node are generated (by evaluating the
+// TPs' predicates for the node's path) when a path through the node is requested for the first time, and kept afterwards.
+// Subtrees found to have no leaf during a request are removed, such that requests only return valid configurations.
+class lazy_tree
+{
+  public:
+    struct node
+    {
+      value_type                           value;
+      node*                                parent   = nullptr;
+      bool                                 expanded = false;
+      std::vector< std::unique_ptr<node> > childs;
+    };
+
+    // ctors
+    lazy_tree()
+      : _layers(), _root( std::make_shared<node>() )
+    {}
+
+    lazy_tree(       lazy_tree&& other ) = default;
+    lazy_tree( const lazy_tree&  other ) = default;
+
+
+    template< typename T, typename range_t, typename callable >
+    void add_tp( const tp_t<T,range_t,callable>& tp, void* tp_value_ptr )
+    {
+      auto tp_copy = tp; // iterates over its own copy of the range
+      _layers.push_back( { tp_value_ptr, tp.get_range_ptr()->size(), [ tp_copy ]() mutable {
+        std::vector< value_type > values;
+        T value;
+        while( tp_copy.get_next_value( value ) )
+          values.emplace_back( value );
+        return values;
+      } } );
+    }
+
+
+    size_t num_params() const
+    {
+      return _layers.size();
+    }
+
+
+    // upper bound of the number of leafs: the size of the Cartesian product of the TPs' ranges
+    big_int num_configs() const
+    {
+      big_int num_configs = 1;
+      for( const auto& layer : _layers )
+        num_configs = num_configs * big_int( layer.range_size );
+
+      return num_configs;
+    }
+
+
+    // upper bound of the number of childs of a node in layer "layer": the size of the layer's range
+    size_t max_childs( size_t layer ) const
+    {
+      return _layers[ layer ].range_size;
+    }
+
+
+    // Stores the TP values of a path at positions "first_pos, first_pos + 1, ..." of "config", where "choose_child( l, num_childs )"
+    // selects the child of the node in layer "l"; a child whose subtree turns out to have no leaf is removed and a child is selected
+    // again among the remaining ones.
+    template< typename chooser_t, typename config_t >
+    void get_path( const chooser_t& choose_child, const std::vector<std::string>& names, size_t first_pos, config_t& config ) const
+    {
+      std::vector< const node* > path;
+      if( !select_path( *_root, 0, choose_child, path ) )
+        throw std::runtime_error( "search space is empty" );
+
+      for( size_t l = 0 ; l < path.size() ; ++l )
+        detail::store_tp_value( config, names, first_pos + l, path[ l ]->value, _layers[ l ].tp_value_ptr );
+    }
+
+
+    // number of childs of the node reached from the root by successively taking the childs "indices"
+    size_t num_childs( const std::vector<size_t>& indices ) const
+    {
+      node* n = _root.get();
+      for( size_t l = 0 ; l < indices.size() ; ++l )
+      {
+        expand( *n, l );
+        assert( indices[ l ] < n->childs.size() );
+        n = n->childs[ indices[ l ] ].get();
+      }
+
+      expand( *n, indices.size() );
+      return n->childs.size();
+    }
+
+  private:
+    struct layer
+    {
+      void*                                     tp_value_ptr;
+      size_t                                    range_size;
+      std::function< std::vector<value_type>() > valid_values; // values fulfilling the predicate for the current values of the other TPs
+    };
+
+    std::vector< layer >  _layers;
+    std::shared_ptr<node> _root;
+
+    // generates the childs of node "n" in layer "l" (the root has layer 0)
+    void expand( node& n, size_t l ) const
+    {
+      if( n.expanded || l == _layers.size() )
+        return;
+
+      // set the TPs of the node's path to the path's values
+      size_t ancestor_layer = l;
+      for( const node* ancestor = &n ; ancestor->parent != nullptr ; ancestor = ancestor->parent )
+        tp_value( ancestor->value, _layers[ --ancestor_layer ].tp_value_ptr ).update_tp();
+
+      for( auto& value : _layers[ l ].valid_values() )
+      {
+        n.childs.emplace_back( std::make_unique<node>() );
+        n.childs.back()->value  = value;
+        n.childs.back()->parent = &n;
+      }
+      n.expanded = true;
+    }
+
+    // returns false iff the subtree of node "n" in layer "l" has no leaf
+    template< typename chooser_t >
+    bool select_path( node& n, size_t l, const chooser_t& choose_child, std::vector< const node* >& path ) const
+    {
+      if( l == _layers.size() )
+        return true;
+
+      expand( n, l );
+      while( !n.childs.empty() )
+      {
+        const size_t i = choose_child( l, n.childs.size() );
+        assert( i < n.childs.size() );
+
+        path.emplace_back( n.childs[ i ].get() );
+        if( select_path( *n.childs[ i ], l + 1, choose_child, path ) )
+          return true;
+
+        path.pop_back();
+        n.childs.erase( n.childs.begin() + i );
+      }
+
+      return false;
+    }
+};
+
+
+
+class search_space_lazy : public search_space
+{
+  public:
+    using tree_type = lazy_tree;
+
+    search_space_lazy()
+      : _trees(), _tp_names()
+    {}
+
+    search_space_lazy( const search_space_lazy&  other ) = default;
+    search_space_lazy(       search_space_lazy&& other ) = default;
+
+    // upper bound of the number of configurations (TPs' constraints are ignored)
+    big_int num_configs() const
+    {
+      big_int num_configs = 1;
+
+      for( const auto& tree : _trees )
+        num_configs = num_configs * tree.num_configs();
+
+      return num_configs;
+    }
+
+
+    void append_new_trees( size_t num ) // as "friend"
+    {
+      auto old_size = _trees.size();
+      _trees.resize( old_size + num );
+    }
+
+    lazy_tree& tree( size_t tree_id )  // as "friend"
+    {
+      return _trees[ tree_id ];
+    }
+
+    void add_name( const std::string& name )
+    {
+      _tp_names.emplace_back( name );
+    }
+
+
+    configuration operator[]( const big_int& index ) const {
+        return get_configuration( index );
+    }
+
+
+    configuration get_configuration( const big_int& index ) const
+    {
+      configuration config;
+      fill_configuration( index, config );
+      return config;
+    }
+
+
+    configuration get_configuration( const coordinates& indices ) const
+    {
+      configuration config;
+      fill_configuration( indices, config );
+      return config;
+    }
+
+
+    configuration get_configuration( const std::vector<size_t>& indices ) const
+    {
+      configuration config;
+      fill_configuration( indices, config );
+      return config;
+    }
+
+
+    // decode into a reused configuration
+    void get_configuration( const big_int& index, flat_configuration& config ) const
+    {
+      config.reset( _tp_names );
+      fill_configuration( index, config );
+    }
+
+
+    void get_configuration( const coordinates& indices, flat_configuration& config ) const
+    {
+      config.reset( _tp_names );
+      fill_configuration( indices, config );
+    }
+
+
+    void get_configuration( const std::vector<size_t>& indices, flat_configuration& config ) const
+    {
+      config.reset( _tp_names );
+      fill_configuration( indices, config );
+    }
+
+
+    // the leafs of lazy trees are not numbered: 1D indices are not unique per configuration
+    big_int index_of( const coordinates& ) const
+    {
+      throw std::runtime_error( "canonical indices are not supported by LAZY_SEARCH_SPACE" );
+    }
+
+
+    // the number of TPs, i.e. the tree depth
+    size_t num_params() const
+    {
+      size_t num_params_of_all_trees = 0;
+
+      for( const auto& tree : _trees )
+        num_params_of_all_trees += tree.num_params();
+
+      return num_params_of_all_trees;
+    }
+
+
+    // upper bound: the size of the layer's range
+    size_t max_childs( size_t layer ) const
+    {
+      assert( layer < this->num_params() );
+
+      for( const auto& tree : _trees )
+      {
+        if( layer < tree.num_params() )
+          return tree.max_childs( layer );
+        else
+          layer -= tree.num_params(); // go to the next config_tree generated by "G(...)"
+      }
+
+      assert( false ); // should never be reached
+
+      return 0;
+    }
+
+
+    // childs are counted before their subtrees are checked for leafs
+    size_t max_childs_of_node( std::vector<size_t>& indices ) const {
+      assert( indices.size() < this->num_params() );
+      size_t tree_index = 0;
+
+      while( indices.size() >= _trees[ tree_index ].num_params() )
+        indices.erase( indices.begin(), indices.begin() + _trees[ tree_index++ ].num_params() );
+
+      return _trees[ tree_index ].num_childs( indices );
+    }
+
+
+    const std::vector< std::string >& names() const
+    {
+      return _tp_names;
+    }
+
+
+    const std::string& name( size_t i ) const
+    {
+      return _tp_names[ i ];
+    }
+
+
+    size_t num_trees() const // as "friend"
+    {
+      return _trees.size();
+    }
+
+  private:
+    std::vector< lazy_tree >   _trees;
+    std::vector< std::string > _tp_names;
+
+    // the index is decoded into one digit per TP (mixed radix of the range sizes), and digit "d" of a TP with range size "s"
+    // selects child "d * n / s" of a node with "n" childs
+    template< typename config_t >
+    void fill_configuration( const big_int& index, config_t& config ) const
+    {
+      if (index > this->num_configs()) {
+        throw std::runtime_error("search space index is out of bounds");
+      }
+
+      std::vector< size_t > digits( this->num_params() );
+      std::vector< size_t > range_sizes( this->num_params() );
+      big_int rest = index;
+      size_t pos = this->num_params();
+      for( int tree_id = static_cast<int>( _trees.size() ) - 1 ; tree_id >= 0 ; --tree_id )
+      {
+        for( int l = static_cast<int>( _trees[ tree_id ].num_params() ) - 1 ; l >= 0 ; --l )
+        {
+          --pos;
+          range_sizes[ pos ] = _trees[ tree_id ].max_childs( l );
+          digits[ pos ]      = static_cast<size_t>( rest % big_int( range_sizes[ pos ] ) );
+          rest               = rest / big_int( range_sizes[ pos ] );
+        }
+      }
+
+      fill_configuration_impl( [&]( size_t i_global, size_t num_childs ) {
+        return static_cast<size_t>( static_cast<unsigned long long>( digits[ i_global ] ) * num_childs / range_sizes[ i_global ] );
+      }, config );
+    }
+
+
+    template< typename config_t >
+    void fill_configuration( const coordinates& indices, config_t& config ) const
+    {
+      assert( indices.size()   == this->num_params() );
+      assert( _tp_names.size() == this->num_params() );
+      if (!atf::valid_coordinates(indices)) {
+        throw std::runtime_error("search space coordinate is out of bounds (0.0,1.0]");
+      }
+
+      fill_configuration_impl( [&]( size_t i_global, size_t num_childs ) {
+        return static_cast<size_t>( std::ceil( indices[ i_global ] * num_childs ) - 1 );
+      }, config );
+    }
+
+
+    // child indices beyond the number of valid childs select the last child
+    template< typename config_t >
+    void fill_configuration( const std::vector<size_t>& indices, config_t& config ) const
+    {
+      assert( indices.size()   == this->num_params() );
+      assert( _tp_names.size() == this->num_params() );
+
+      fill_configuration_impl( [&]( size_t i_global, size_t num_childs ) {
+        return std::min( indices[ i_global ], num_childs - 1 );
+      }, config );
+    }
+
+
+    template< typename chooser_t, typename config_t >
+    void fill_configuration_impl( const chooser_t& choose_child, config_t& config ) const
+    {
+      size_t i_global = 0;
+      for( const auto& tree : _trees )
+      {
+        tree.get_path( [&]( size_t l, size_t num_childs ){ return choose_child( i_global + l, num_childs ); }, _tp_names, i_global, config );
+        i_global += tree.num_params();
+      }
+
+      assert( i_global == config.size() );
+    }
+};
+
+
+} // namespace "atf"
+
+
+#endif /* search_space_lazy_h */
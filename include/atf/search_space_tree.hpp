@@ -11,6 +11,8 @@
 #include "tp_value_node.hpp"
 #include "tp_value.hpp"
 #include "search_space.hpp"
+#include "flat_configuration.hpp"
+#include "detail/index_strides.hpp"
 
 namespace atf
 {
@@ -20,7 +22,7 @@ class Tree
   public:
     // ctors
     Tree()
-      : _root( std::make_unique<tp_value_node>() ), _leafs()
+      : _root( std::make_unique<tp_value_node>() ), _num_leafs( 0 ), _depth( 0 )
     {}
     
     Tree(       Tree&& other ) = default;
@@ -29,20 +31,46 @@ class Tree
 
     big_int num_configs() const
     {
-      return _leafs.size();
+      return _num_leafs;
+    }
+
+
+    size_t num_leafs() const
+    {
+      return _num_leafs;
     }
   
   
     size_t depth() const
     {
-      return _root->num_params();
+      return _depth;
     }
   
     template< typename... Ts >
     void insert( Ts... params )
     {
-      const tp_value_node& leaf = _root->insert( params... );
-      _leafs.emplace_back( &leaf );
+      _root->insert( _num_leafs, params... );
+      ++_num_leafs;
+      _depth = std::max( _depth, sizeof...( params ) );
+    }
+
+
+    // inserts a path of (value, TP value pointer) pairs determined at runtime
+    void insert_path( const std::vector< std::pair<value_type, void*> >& path )
+    {
+      _root->insert_path( _num_leafs, path.data(), path.size() );
+      ++_num_leafs;
+      _depth = std::max( _depth, path.size() );
+    }
+
+
+    // appends the paths of "subtree" behind the paths of this tree (used to merge subtrees generated in parallel)
+    void append( Tree&& subtree )
+    {
+      _root->append_childs( *subtree._root, _num_leafs, subtree._num_leafs );
+      _num_leafs += subtree._num_leafs;
+      _depth      = std::max( _depth, subtree._depth );
+      subtree._num_leafs = 0;
     }
 
 
@@ -52,9 +80,12 @@ class Tree
     }
 
   
+    // resolved by descending from the root via the nodes' leaf offsets
     const tp_value_node& leaf( size_t i ) const
     {
-      return *_leafs[ i ];
+      assert( i < _num_leafs );
+
+      return _root->leaf( i, _num_leafs );
     }
   
   
@@ -74,10 +105,9 @@ class Tree
     }
 
 
-    template< typename... Ts >
-    size_t num_params( Ts... params ) const
+    size_t num_params() const
     {
-      return _root->num_params( params... );
+      return _depth;
     }
 
   
@@ -89,8 +119,9 @@ class Tree
     
 
   private:
-    std::shared_ptr< tp_value_node >    _root;
-    std::vector< tp_value_node const* > _leafs;
+    std::shared_ptr< tp_value_node > _root;
+    size_t                           _num_leafs;
+    size_t                           _depth;
 };
 
 
@@ -98,8 +129,10 @@ class Tree
 class search_space_tree : public search_space
 {
   public:
+    using tree_type = Tree;
+
     search_space_tree()
-      : _trees(), _tp_names()
+      : _trees(), _tp_names(), _index_strides()
     {}
   
     search_space_tree( const search_space_tree&  other ) = default;
@@ -107,6 +140,9 @@ class search_space_tree : public search_space
 
     big_int num_configs() const
     {
+      if( _index_strides.num_trees() == _trees.size() )
+        return _index_strides.num_configs();
+
       big_int num_configs = 1;
       
       for( const auto& tree : _trees )
@@ -114,6 +150,13 @@ class search_space_tree : public search_space
       
       return num_configs;
     }
+
+
+    // precomputes the strides of the trees in the index space; called after generation
+    void update_index_strides()
+    {
+      _index_strides.compute( num_leafs_of_trees() );
+    }
   
   
     void append_new_trees( size_t num ) // as "friend"
@@ -148,95 +191,75 @@ class search_space_tree : public search_space
 
     configuration get_configuration( const big_int& index ) const
     {
-      if (index > this->num_configs()) {
-        throw std::runtime_error("search space index is out of bounds");
-      }
-
-      auto config = configuration{};
-      size_t pos = this->num_params() - 1;
-      
-      // iterate over trees (bottom-up)
-      for( int tree_id = static_cast<int>( _trees.size() ) - 1 ; tree_id >= 0 ; --tree_id )
-      {
-        const auto& tree = _trees[ tree_id ];
+      configuration config;
+      fill_configuration( index, config );
+      return config;
+    }
 
-        // select leaf
-        big_int num_configs_of_lower_trees = 1;
-        for( int lower_tree = tree_id + 1; lower_tree < _trees.size() ; ++lower_tree )
-          num_configs_of_lower_trees = num_configs_of_lower_trees * _trees[ lower_tree ].num_configs();
 
-        auto leaf_id = ( index / num_configs_of_lower_trees ) % tree.num_configs();
-        // go leaf up and insert TP values in config
-        tp_value_node const* tree_node = &tree.leaf( static_cast<size_t>(leaf_id) );
-        for( size_t i = 0 ; i < tree.num_params() ; ++i )
-        {
-            config.emplace( std::piecewise_construct,
-                            std::forward_as_tuple( this->name(pos)                               ),
-                            std::forward_as_tuple( tree_node->value(), tree_node->tp_value_ptr() )
-            );
-            --pos;
-            tree_node = &( tree_node->parent() );
-        }
-      }
-      
+    configuration get_configuration( const coordinates& indices ) const
+    {
+      configuration config;
+      fill_configuration( indices, config );
       return config;
     }
-  
-  
-    configuration get_configuration( const coordinates& indices ) const {
-      assert( indices.size()   == this->num_params() );
-      assert( _tp_names.size() == this->num_params() );
-      if (!atf::valid_coordinates(indices)) {
-        throw std::runtime_error("search space coordinate is out of bounds (0.0,1.0]");
-      }
 
-      configuration config;
-      size_t i_global = 0;
-      for( const auto& tree : _trees )
-      {
-        const tp_value_node* tree_node = &tree.root();
-        for( size_t i = 0 ; i < tree.num_params() ; ++i, ++i_global )
-        {
-          tree_node = &( tree_node->child( std::ceil(indices[ i_global ] * tree_node->num_childs()) - 1 ) );
-          config.emplace( std::piecewise_construct,
-                          std::forward_as_tuple( this->name(i_global)                          ),
-                          std::forward_as_tuple( tree_node->value(), tree_node->tp_value_ptr() )
-                        );
-        }
-      }
 
-      assert( i_global == config.size() );
+    configuration get_configuration( const std::vector<size_t>& indices ) const
+    {
+      configuration config;
+      fill_configuration( indices, config );
       return config;
     }
 
 
-    configuration get_configuration( const std::vector<size_t>& indices ) const
+    // decode into a reused configuration
+    void get_configuration( const big_int& index, flat_configuration& config ) const
     {
-      assert( indices.size()   == this->num_params() );
-      assert( _tp_names.size() == this->num_params() );
+      config.reset( _tp_names );
+      fill_configuration( index, config );
+    }
 
 
-      configuration config;
+    void get_configuration( const coordinates& indices, flat_configuration& config ) const
+    {
+      config.reset( _tp_names );
+      fill_configuration( indices, config );
+    }
+
+
+    void get_configuration( const std::vector<size_t>& indices, flat_configuration& config ) const
+    {
+      config.reset( _tp_names );
+      fill_configuration( indices, config );
+    }
+
+
+    // index "i" with "get_configuration( i ) == get_configuration( indices )"; a leaf's id in its tree is the sum of the leaf offsets on its path
+    big_int index_of( const coordinates& indices ) const
+    {
+      assert( indices.size() == this->num_params() );
+      assert( _index_strides.num_trees() == _trees.size() );
+      if (!atf::valid_coordinates(indices)) {
+        throw std::runtime_error("search space coordinate is out of bounds (0.0,1.0]");
+      }
+
+      std::vector< size_t > leaf_ids;
       size_t i_global = 0;
       for( const auto& tree : _trees )
       {
         const tp_value_node* tree_node = &tree.root();
+        size_t leaf_id = 0;
         for( size_t i = 0 ; i < tree.num_params() ; ++i, ++i_global )
         {
-          tree_node = &( tree_node->child( indices[ i_global ] ) );
-          config.emplace( std::piecewise_construct,
-                          std::forward_as_tuple( this->name(i_global)                          ),
-                          std::forward_as_tuple( tree_node->value(), tree_node->tp_value_ptr() )
-                        );
+          tree_node = &( tree_node->child( std::ceil(indices[ i_global ] * tree_node->num_childs()) - 1 ) );
+          leaf_id  += tree_node->leaf_offset();
         }
+        leaf_ids.emplace_back( leaf_id );
       }
 
-      assert( i_global == config.size() );       return config;
+      return _index_strides.encode( leaf_ids );
     }
-  
-  
-
-  
 
 
     // the number of TPs, i.e. the tree depth
@@ -316,8 +339,96 @@ class search_space_tree : public search_space
     }
   
   private:
+    template< typename config_t >
+    void fill_configuration( const big_int& index, config_t& config ) const
+    {
+      // strides are computed here if the trees have changed since the last "update_index_strides()"
+      detail::index_strides current_strides;
+      const detail::index_strides* strides = &_index_strides;
+      if( _index_strides.num_trees() != _trees.size() )
+      {
+        current_strides.compute( num_leafs_of_trees() );
+        strides = &current_strides;
+      }
+
+      if (index > strides->num_configs()) {
+        throw std::runtime_error("search space index is out of bounds");
+      }
+
+      size_t first_param = 0;
+      strides->decode( index, [&]( size_t tree_id, size_t leaf_id ) {
+        const auto& tree = _trees[ tree_id ];
+
+        // go leaf up and insert TP values in config
+        size_t pos = first_param + tree.num_params() - 1;
+        tp_value_node const* tree_node = &tree.leaf( leaf_id );
+        for( size_t i = 0 ; i < tree.num_params() ; ++i )
+        {
+            detail::store_tp_value( config, _tp_names, pos, tree_node->value(), tree_node->tp_value_ptr() );
+            --pos;
+            tree_node = &( tree_node->parent() );
+        }
+        first_param += tree.num_params();
+      } );
+    }
+
+
+    template< typename config_t >
+    void fill_configuration( const coordinates& indices, config_t& config ) const
+    {
+      assert( indices.size()   == this->num_params() );
+      assert( _tp_names.size() == this->num_params() );
+      if (!atf::valid_coordinates(indices)) {
+        throw std::runtime_error("search space coordinate is out of bounds (0.0,1.0]");
+      }
+
+      size_t i_global = 0;
+      for( const auto& tree : _trees )
+      {
+        const tp_value_node* tree_node = &tree.root();
+        for( size_t i = 0 ; i < tree.num_params() ; ++i, ++i_global )
+        {
+          tree_node = &( tree_node->child( std::ceil(indices[ i_global ] * tree_node->num_childs()) - 1 ) );
+          detail::store_tp_value( config, _tp_names, i_global, tree_node->value(), tree_node->tp_value_ptr() );
+        }
+      }
+
+      assert( i_global == config.size() );
+    }
+
+
+    template< typename config_t >
+    void fill_configuration( const std::vector<size_t>& indices, config_t& config ) const
+    {
+      assert( indices.size()   == this->num_params() );
+      assert( _tp_names.size() == this->num_params() );
+
+      size_t i_global = 0;
+      for( const auto& tree : _trees )
+      {
+        const tp_value_node* tree_node = &tree.root();
+        for( size_t i = 0 ; i < tree.num_params() ; ++i, ++i_global )
+        {
+          tree_node = &( tree_node->child( indices[ i_global ] ) );
+          detail::store_tp_value( config, _tp_names, i_global, tree_node->value(), tree_node->tp_value_ptr() );
+        }
+      }
+
+      assert( i_global == config.size() );
+    }
+
     std::vector< Tree >        _trees;
     std::vector< std::string > _tp_names;
+    detail::index_strides      _index_strides;
+
+    std::vector< size_t > num_leafs_of_trees() const
+    {
+      std::vector< size_t > num_leafs;
+      for( const auto& tree : _trees )
+        num_leafs.emplace_back( tree.num_leafs() );
+
+      return num_leafs;
+    }
 };
 
 
@@ -2,11 +2,17 @@
 #define ATF_SEARCH_TECHNIQUE_HPP
 
 #include <set>
+#include <map>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
 
 namespace atf {
 
 using coordinates = std::vector<double>;
 using cost_t = double;
+using objective_vector = std::vector<cost_t>;
 
 /**
  * Searches over multi-dimensional coordinate space (0,1]^D.
@@ -42,6 +48,61 @@ class search_technique {
      * @param costs coordinates mapped to their costs
      */
     virtual void report_costs(const std::map<coordinates, cost_t>& costs) = 0;
+
+    /**
+     * Processes the objective vectors for coordinates requested via function `get_next_coordinates()`, if the tuner has objectives (see
+     * `tuner::objectives(...)`); the costs reported by `report_costs(...)` are then their scalarizations.
+     *
+     * Function `report_objectives(...)` is called by ATF right before the corresponding call to `report_costs(...)`; coordinates
+     * whose evaluation failed or whose objectives are unknown have no entry. Techniques that search for the scalarized cost
+     * only keep this implementation, which ignores the objectives.
+     *
+     * @param objectives coordinates mapped to their objective vectors
+     */
+    virtual void report_objectives(const std::map<coordinates, objective_vector>& /* objectives */)
+    {
+    }
+
+    /**
+     * Sets the number of configurations that ATF can evaluate concurrently (see `tuner::evaluation_threads(...)`) or hold in its
+     * evaluation pipeline (see `tuner::pipelined(...)`); the technique may then return up to this many coordinates per call of
+     * `get_next_coordinates()`.
+     *
+     * Function `set_batch_size(...)` is called by ATF after `initialize(...)`. Techniques that request one point at a time keep
+     * this implementation, which ignores the batch size.
+     *
+     * @param batch_size maximum number of coordinates that are evaluated concurrently or pipelined
+     */
+    virtual void set_batch_size(size_t /* batch_size */)
+    {
+    }
+
+    /**
+     * Writes the state of the search technique to `out`, such that `load_state(...)` continues the search from this state
+     * (e.g., when a tuning run is resumed).
+     *
+     * Function `save_state(...)` is called by ATF between a call to `report_costs(...)` and the next call to `get_next_coordinates()`,
+     * and once before the first call to `get_next_coordinates()` if checkpoints are enabled, such that techniques that do not support
+     * checkpoints fail before any configuration is evaluated. These techniques keep this implementation, which throws.
+     *
+     * @param out stream to write the state to
+     */
+    virtual void save_state(std::ostream& /* out */) const
+    {
+      throw std::runtime_error( "search technique does not support checkpoints" );
+    }
+
+    /**
+     * Restores a state written by function `save_state(...)`.
+     *
+     * Function `load_state(...)` is called by ATF after `initialize(...)`, for the same search space.
+     *
+     * @param in stream to read the state from
+     */
+    virtual void load_state(std::istream& /* in */)
+    {
+      throw std::runtime_error( "search technique does not support checkpoints" );
+    }
 };
 
 }
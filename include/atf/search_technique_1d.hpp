@@ -3,12 +3,17 @@
 
 #include <set>
 #include <map>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
 #include "big_int.hpp"
 
 namespace atf {
 
 using index = atf::big_int;
 using cost_t = double;
+using objective_vector = std::vector<cost_t>;
 
 /**
  * Searches over one-dimensional index space { 0 , ... , |SP|-1 }, where |SP| is the search space size.
@@ -44,6 +49,61 @@ class search_technique_1d {
      * @param costs indices mapped to their costs
      */
     virtual void report_costs(const std::map<index, cost_t>& costs) = 0;
+
+    /**
+     * Processes the objective vectors for indices requested via function `get_next_indices()`, if the tuner has objectives (see
+     * `tuner::objectives(...)`); the costs reported by `report_costs(...)` are then their scalarizations.
+     *
+     * Function `report_objectives(...)` is called by ATF right before the corresponding call to `report_costs(...)`; indices
+     * whose evaluation failed or whose objectives are unknown have no entry. Techniques that search for the scalarized cost
+     * only keep this implementation, which ignores the objectives.
+     *
+     * @param objectives indices mapped to their objective vectors
+     */
+    virtual void report_objectives(const std::map<index, objective_vector>& /* objectives */)
+    {
+    }
+
+    /**
+     * Sets the number of configurations that ATF can evaluate concurrently (see `tuner::evaluation_threads(...)`) or hold in its
+     * evaluation pipeline (see `tuner::pipelined(...)`); the technique may then return up to this many indices per call of
+     * `get_next_indices()`.
+     *
+     * Function `set_batch_size(...)` is called by ATF after `initialize(...)`. Techniques that request one point at a time keep
+     * this implementation, which ignores the batch size.
+     *
+     * @param batch_size maximum number of indices that are evaluated concurrently or pipelined
+     */
+    virtual void set_batch_size(size_t /* batch_size */)
+    {
+    }
+
+    /**
+     * Writes the state of the search technique to `out`, such that `load_state(...)` continues the search from this state
+     * (e.g., when a tuning run is resumed).
+     *
+     * Function `save_state(...)` is called by ATF between a call to `report_costs(...)` and the next call to `get_next_indices()`,
+     * and once before the first call to `get_next_indices()` if checkpoints are enabled, such that techniques that do not support
+     * checkpoints fail before any configuration is evaluated. These techniques keep this implementation, which throws.
+     *
+     * @param out stream to write the state to
+     */
+    virtual void save_state(std::ostream& /* out */) const
+    {
+      throw std::runtime_error( "search technique does not support checkpoints" );
+    }
+
+    /**
+     * Restores a state written by function `save_state(...)`.
+     *
+     * Function `load_state(...)` is called by ATF after `initialize(...)`, for the same search space.
+     *
+     * @param in stream to read the state from
+     */
+    virtual void load_state(std::istream& /* in */)
+    {
+      throw std::runtime_error( "search technique does not support checkpoints" );
+    }
 };
 
 }
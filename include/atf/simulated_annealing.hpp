@@ -8,6 +8,7 @@
 #include <limits>
 
 #include "search_technique.hpp"
+#include "detail/technique_state.hpp"
 
 namespace atf {
 
@@ -141,6 +142,39 @@ class simulated_annealing : public search_technique
     void finalize() override
     {}
 
+    // the temperature schedule is recomputed by "initialize"
+    void save_state( std::ostream& out ) const override
+    {
+      detail::save_value( out, static_cast<int>( _current_state ) );
+      detail::save_value( out, _time );
+      detail::save_value( out, _current_parameter );
+      detail::save_value( out, _best_result );
+      detail::save_value( out, _temp );
+      detail::save_value( out, _step_size );
+      detail::save_value( out, _current_coordinates );
+      detail::save_value( out, _best_coordinates );
+      detail::save_value( out, _neighbours );
+      detail::save_value( out, _dre );
+      detail::save_value( out, _urd );
+    }
+
+    void load_state( std::istream& in ) override
+    {
+      int current_state;
+      detail::load_value( in, current_state );
+      _current_state = static_cast<State>( current_state );
+      detail::load_value( in, _time );
+      detail::load_value( in, _current_parameter );
+      detail::load_value( in, _best_result );
+      detail::load_value( in, _temp );
+      detail::load_value( in, _step_size );
+      detail::load_value( in, _current_coordinates );
+      detail::load_value( in, _best_coordinates );
+      detail::load_value( in, _neighbours );
+      detail::load_value( in, _dre );
+      detail::load_value( in, _urd );
+    }
+
 
   private:
     /** holds the default number of steps to interpolate */
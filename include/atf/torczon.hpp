@@ -7,6 +7,7 @@
 
 
 #include "search_technique.hpp"
+#include "detail/technique_state.hpp"
 
 
 #define INIT_SIMPLEX_NORMALIZED_SIDE_LENGTH 0.1
@@ -72,6 +73,43 @@ class torczon : public search_technique
     void finalize() override
     {}
 
+
+    void save_state( std::ostream& out ) const override
+    {
+      detail::save_value( out, _rnd_generator );
+      detail::save_value( out, _base_simplex.best_vertex_index );
+      detail::save_value( out, _base_simplex.simp );
+      detail::save_value( out, _test_simplex.best_vertex_index );
+      detail::save_value( out, _test_simplex.simp );
+      detail::save_value( out, _current_simplex == &_test_simplex );
+      detail::save_value( out, _current_vertex_index );
+      detail::save_value( out, _current_center_index );
+      detail::save_value( out, static_cast<int>( _current_state ) );
+      detail::save_value( out, _best_cost );
+      detail::save_value( out, _cost_improved );
+    }
+
+
+    void load_state( std::istream& in ) override
+    {
+      bool current_is_test_simplex;
+      int  current_state;
+      detail::load_value( in, _rnd_generator );
+      detail::load_value( in, _base_simplex.best_vertex_index );
+      detail::load_value( in, _base_simplex.simp );
+      detail::load_value( in, _test_simplex.best_vertex_index );
+      detail::load_value( in, _test_simplex.simp );
+      detail::load_value( in, current_is_test_simplex );
+      detail::load_value( in, _current_vertex_index );
+      detail::load_value( in, _current_center_index );
+      detail::load_value( in, current_state );
+      detail::load_value( in, _best_cost );
+      detail::load_value( in, _cost_improved );
+
+      _current_simplex = current_is_test_simplex ? &_test_simplex : &_base_simplex;
+      _current_state   = static_cast<torczon_state>( current_state );
+    }
+
   private:
     size_t _dimensionality;
 
@@ -3,15 +3,111 @@
 #define tp_h
 
 #include <vector>
+#include <string>
 #include <functional>
 #include <math.h>
 #include <memory>
+#include <limits>
+#include <assert.h>
 
 #include "range.hpp"
+#include "detail/candidate_values.hpp"
 
 namespace atf
 {
 
+namespace detail
+{
+
+// id of the search space generation worker running on the calling thread (0: thread is no generation worker)
+inline size_t& generation_worker_id()
+{
+  static thread_local size_t id = 0;
+  return id;
+}
+
+
+// predicate of TPs defined without a predicate; stateless, so that search space files can be keyed without a user key, and
+// reads no TPs, so that such TPs are generated in trees of their own
+struct accept_all
+{
+  template< typename T >
+  bool operator()( const T& ) const
+  {
+    return true;
+  }
+
+  template< typename hash_t >
+  bool hash_parameters( hash_t& ) const
+  {
+    return true;
+  }
+};
+
+
+// true iff TP values are enumerated from the candidates of a structured predicate: the range is an interval of plain integers
+template< typename T, typename range_t, typename callable >
+struct enumerates_candidates : std::false_type {};
+
+template< typename T, typename callable >
+struct enumerates_candidates< T, interval_class<T,identity,T>, callable >
+  : std::integral_constant< bool, std::is_integral<T>::value && !std::is_same<T,bool>::value && is_structured_predicate<callable,T>::value > {};
+
+
+// current value of a TP; generation workers use their own value slots so that they can evaluate predicates concurrently
+template< typename T >
+class tp_act_elem
+{
+  public:
+    tp_act_elem()
+      : _value(), _worker_values(), _num_workers( 0 ), _position( std::numeric_limits<size_t>::max() )
+    {}
+
+    T& get()
+    {
+      const size_t worker_id = generation_worker_id();
+      if( worker_id == 0 || worker_id > _num_workers )
+        return _value;
+
+      return _worker_values[ worker_id - 1 ];
+    }
+
+    // must not be called while generation workers are running
+    void set_num_workers( size_t num_workers )
+    {
+      if( num_workers > _num_workers )
+      {
+        _worker_values = std::unique_ptr<T[]>( new T[ num_workers ]() );
+        _num_workers   = num_workers;
+      }
+    }
+
+    // value slot of the main thread, used by "tp_value::update_tp()"
+    T* value_ptr()
+    {
+      return &_value;
+    }
+
+    // position of the TP in the search space it was last added to
+    size_t position() const
+    {
+      return _position;
+    }
+
+    void set_position( size_t position )
+    {
+      _position = position;
+    }
+
+  private:
+    T                    _value;
+    std::unique_ptr<T[]> _worker_values;
+    size_t               _num_workers;
+    size_t               _position;
+};
+
+} // namespace "detail"
+
 
 template< typename T, typename range_t, typename callable >
 class tp_t
@@ -22,7 +118,7 @@ class tp_t
     using type = T;
   
         tp_t( const std::string& name, range_t range, const callable& predicate = [](T){ return true; } )
-      : _name( name ), _range( range ), _predicate( predicate ), _act_elem( std::make_shared<T>() )
+      : _name( name ), _range( range ), _predicate( predicate ), _act_elem( std::make_shared<detail::tp_act_elem<T>>() )
     {}
   
   
@@ -33,28 +129,18 @@ class tp_t
   
         bool get_next_value( T& elem )
     {
-      // get next element
-      if( !_range.next_elem( elem ) )
-        return false;
-
-      // while predicate is not fullfilled on "elem" then get next element
-      while( !_predicate( elem ) )
-        if( !_range.next_elem( elem ) )
-          return false;
-
-      *_act_elem = elem;
-      return true;
+      return get_next_value( elem, detail::enumerates_candidates<T,range_t,callable>() );
     }
   
     operator T() const
     {
-      return *_act_elem;
+      return _act_elem->get();
     }
   
   
     auto cast() const
     {
-      return *_act_elem;
+      return _act_elem->get();
     }
   
   
@@ -62,14 +148,70 @@ class tp_t
     {
       return &_range;
     }
+
+
+    // handle of the TP in configurations: its position in the search space ("flat_configuration" is indexed by it)
+    size_t position() const
+    {
+      assert( _act_elem->position() != std::numeric_limits<size_t>::max() && "TP is not part of a search space" );
+      return _act_elem->position();
+    }
   
   
 
   private:
+    bool get_next_value( T& elem, std::false_type )
+    {
+      // get next element
+      if( !_range.next_elem( elem ) )
+        return false;
+
+      // while predicate is not fullfilled on "elem" then get next element
+      while( !_predicate( elem ) )
+        if( !_range.next_elem( elem ) )
+          return false;
+
+      _act_elem->get() = elem;
+      return true;
+    }
+
+    // integer interval with structured predicate: the candidates are narrowed once per pass over the range
+    bool get_next_value( T& elem, std::true_type )
+    {
+      if( !_in_pass )
+      {
+        detail::candidate_values<T> candidates;
+        _predicate.narrow( candidates );
+        _narrowed = _candidates.start( _range.first(), _range.last(), _range.step_size(), candidates );
+        _in_pass  = true;
+      }
+
+      if( !_narrowed )
+      {
+        _in_pass = get_next_value( elem, std::false_type() );
+        return _in_pass;
+      }
+
+      while( _candidates.next( elem ) )
+      {
+        if( _predicate( elem ) )
+        {
+          _act_elem->get() = elem;
+          return true;
+        }
+      }
+
+      _in_pass = false;
+      return false;
+    }
+
     const std::string        _name;
           range_t            _range;
     const callable           _predicate;
-          std::shared_ptr<T> _act_elem;
+          std::shared_ptr<detail::tp_act_elem<T>> _act_elem;
+          detail::candidate_cursor<T>             _candidates;
+          bool                                    _in_pass  = false;
+          bool                                    _narrowed = false;
 };
 
 
@@ -84,7 +226,7 @@ auto tuning_parameter(const std::string& name, range_t range, const callable& pr
 template< typename range_t, typename T = typename range_t::in_type >
 auto tuning_parameter(const std::string& name, range_t range )
 {
-  return tuning_parameter(name, range, [](T) { return true; });
+  return tuning_parameter(name, range, detail::accept_all());
 }
 
 
@@ -103,7 +245,7 @@ auto tuning_parameter(const std::string& name, const std::initializer_list<T>& e
 template< typename T >
 auto tuning_parameter(const std::string& name, const std::vector<T>& elems )
 {
-  return tuning_parameter(name, elems, [](T) { return true; });
+  return tuning_parameter(name, elems, detail::accept_all());
 }
 
 template< typename T, typename callable >
@@ -117,12 +259,12 @@ auto tuning_parameter(const std::string& name, const std::vector<T>& elems, cons
 template< typename T >
 auto tuning_parameter(const std::string& name, const std::initializer_list<T>& elems )
 {
-  return tuning_parameter(name, elems, [](T) { return true; });
+  return tuning_parameter(name, elems, detail::accept_all());
 }
-tp_t<std::string,set<std::string>,std::function<bool(std::string)>> tuning_parameter(const std::string& name, const std::initializer_list<const char*>& elems )
+tp_t<std::string,set<std::string>,detail::accept_all> tuning_parameter(const std::string& name, const std::initializer_list<const char*>& elems )
 {
   std::vector<std::string> elems_as_strings(elems.begin(), elems.end());
-  return {name, set<std::string>(elems_as_strings), [](std::string) -> bool { return true; } };
+  return {name, set<std::string>(elems_as_strings), detail::accept_all() };
 }
 
 
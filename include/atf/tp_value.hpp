@@ -25,6 +25,20 @@ class tp_value
       : _value( value ), _tp_value_ptr( tp_value_ptr )
     {}
   
+    // reuses the storage of the current value (e.g., the buffer of a string value)
+    void assign( const value_type& value, void* tp_value_ptr )
+    {
+      _value        = value;
+      _tp_value_ptr = tp_value_ptr;
+    }
+
+
+    void* tp_value_ptr() const
+    {
+      return _tp_value_ptr;
+    }
+
+
     // read / write
     value_type&  value()
     {
@@ -48,6 +62,10 @@ class tp_value
           throw std::exception();
           break;
 
+        case value_type::bool_t:
+          *static_cast<bool*>( _tp_value_ptr ) = _value.bool_val();
+          break;
+
         case value_type::int_t:
           *static_cast<int*>( _tp_value_ptr ) = _value.int_val();
           break;
@@ -5,6 +5,8 @@
 #include <vector>
 #include <assert.h>
 #include <memory>
+#include <atomic>
+#include <algorithm>
 
 #include "value_type.hpp"
 
@@ -16,15 +18,15 @@ class tp_value_node
 {
   public:
     tp_value_node()
-      : _value(), _parent( nullptr ), _childs(), _depth( 0 )
+      : _value(), _parent( nullptr ), _childs(), _leaf_offset( 0 )
     {
       ++__number_tree_nodes;
     }
   
 
     template< typename T >
-    tp_value_node( const T& value, void* tp_value_ptr, tp_value_node* parent )
-      : _value( value ), _tp_value_ptr( tp_value_ptr ), _parent( parent ), _childs(), _depth( 0 )
+    tp_value_node( const T& value, void* tp_value_ptr, tp_value_node* parent, size_t leaf_offset )
+      : _value( value ), _tp_value_ptr( tp_value_ptr ), _parent( parent ), _childs(), _leaf_offset( leaf_offset )
     {
       ++__number_tree_nodes;
     }
@@ -36,7 +38,7 @@ class tp_value_node
     tp_value_node( const tp_value_node&& other ) = delete;
 //    }
 
-    auto value() const
+    const value_type& value() const
     {
       return _value;
     }
@@ -77,37 +79,115 @@ class tp_value_node
   
     size_t num_params() const
     {
-      return _depth;
+      return _childs.empty() ? 0 : 1 + _childs.front()->num_params();
+    }
+
+
+    // number of leafs in the subtrees of the preceding siblings
+    size_t leaf_offset() const
+    {
+      return _leaf_offset;
+    }
+
+
+    // number of leafs in the subtree of the "i"-th child, for a node whose subtree has "num_leafs" leafs
+    size_t num_leafs_of_child( size_t i, size_t num_leafs ) const
+    {
+      const size_t end = ( i + 1 < _childs.size() ) ? _childs[ i + 1 ]->_leaf_offset : num_leafs;
+      return end - _childs[ i ]->_leaf_offset;
+    }
+
+
+    // "i"-th leaf of the subtree, for a node whose subtree has "num_leafs" leafs (binary search over the childs' leaf offsets)
+    const tp_value_node& leaf( size_t i, size_t num_leafs ) const
+    {
+      const tp_value_node* node = this;
+      while( !node->_childs.empty() )
+      {
+        const auto& childs = node->_childs;
+        auto it = std::upper_bound( childs.begin(), childs.end(), i, []( size_t leaf_id, const auto& child ){ return leaf_id < child->_leaf_offset; } );
+        assert( it != childs.begin() );
+        const size_t child_id = std::distance( childs.begin(), it ) - 1;
+
+        num_leafs = node->num_leafs_of_child( child_id, num_leafs );
+        i        -= childs[ child_id ]->_leaf_offset;
+        node      = childs[ child_id ].get();
+      }
+
+      assert( i == 0 );
+      return *node;
     }
   
   
-    // return value is leaf node corresponding to the inserted path
+    // inserts a path into the subtree, for a node whose subtree has "num_leafs" leafs before insertion;
+    // each path gets its own leaf; return value is leaf node corresponding to the inserted path
     template< typename T, typename... T_rest >
-    const tp_value_node& insert( T fst, T_rest... rest )
+    const tp_value_node& insert( size_t num_leafs, T fst, T_rest... rest )
     {
       auto value        = std::get<0>( fst );
       auto tp_value_ptr = std::get<1>( fst );
-      const size_t num_params = 1 + sizeof...( rest );
-      if( _depth < num_params )
-        _depth = num_params;
       
-      if( _childs.empty() || value != static_cast< decltype(value) >( _childs.back()->value() ) )       {
+      if( _childs.empty() || sizeof...( rest ) == 0 || value != static_cast< decltype(value) >( _childs.back()->value() ) )       {
         auto parent = this;
-        _childs.emplace_back( std::make_unique<tp_value_node>( value, tp_value_ptr, parent ) );
-        return _childs.back()->insert( rest... );
+        _childs.emplace_back( std::make_unique<tp_value_node>( value, tp_value_ptr, parent, num_leafs ) );
+        return _childs.back()->insert( 0, rest... );
       }
       
       else
-        return _childs.back()->insert( rest... );
+        return _childs.back()->insert( num_leafs - _childs.back()->_leaf_offset, rest... );
     }
   
   
 
     // returns corresponding leaf node
-    const tp_value_node& insert()
+    const tp_value_node& insert( size_t )
     {
       return *this;
     }
+
+
+    // as "insert", for a path of "length" (value, TP value pointer) pairs determined at runtime
+    const tp_value_node& insert_path( size_t num_leafs, const std::pair<value_type, void*>* path, size_t length )
+    {
+      if( length == 0 )
+        return *this;
+
+      if( _childs.empty() || length == 1 || path->first != _childs.back()->_value )
+      {
+        auto parent = this;
+        _childs.emplace_back( std::make_unique<tp_value_node>( path->first, path->second, parent, num_leafs ) );
+        return _childs.back()->insert_path( 0, path + 1, length - 1 );
+      }
+
+      else
+        return _childs.back()->insert_path( num_leafs - _childs.back()->_leaf_offset, path + 1, length - 1 );
+    }
+
+
+    // moves the childs of "other" behind the childs of this node, for nodes whose subtrees have "num_leafs" and "other_num_leafs" leafs;
+    // as in "insert", an inner node is merged with the last child if both have the same value, such that appending subtrees in order
+    // yields the same tree as inserting their paths
+    void append_childs( tp_value_node& other, size_t num_leafs, size_t other_num_leafs )
+    {
+      for( size_t i = 0 ; i < other._childs.size() ; ++i )
+      {
+        auto&        child                = other._childs[ i ];
+        const size_t num_leafs_of_child   = other.num_leafs_of_child( i, other_num_leafs );
+
+        if( !_childs.empty() && child->num_childs() > 0 && !( child->_value != _childs.back()->_value ) )
+          _childs.back()->append_childs( *child, num_leafs - _childs.back()->_leaf_offset, num_leafs_of_child );
+        else
+        {
+          child->_parent      = this;
+          child->_leaf_offset = num_leafs;
+          _childs.emplace_back( std::move( child ) );
+        }
+
+        num_leafs += num_leafs_of_child;
+      }
+
+      other._childs.clear();
+    }
   
   
     void print() const
@@ -135,7 +215,7 @@ class tp_value_node
     void*                                          _tp_value_ptr;
     tp_value_node*                                 _parent;
     std::vector< std::unique_ptr<tp_value_node> >  _childs;
-    size_t                                         _depth;
+    size_t                                         _leaf_offset;
 
 // static member
   public:
@@ -145,10 +225,10 @@ class tp_value_node
     }
   
   private:
-    static size_t __number_tree_nodes;
+    static std::atomic<size_t> __number_tree_nodes;
   
 };
-size_t tp_value_node::__number_tree_nodes = 0;
+std::atomic<size_t> tp_value_node::__number_tree_nodes{ 0 };
 
 } // namespace "atf"
 
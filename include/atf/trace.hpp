@@ -0,0 +1,263 @@
+#ifndef trace_h
+#define trace_h
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace atf
+{
+
+namespace detail
+{
+
+// span of a thread, with nanosecond timestamps of "std::chrono::steady_clock"
+struct trace_event
+{
+  const char*    name;     // string literal
+  const char*    category; // string literal
+  std::int64_t   begin_ns;
+  std::int64_t   end_ns;
+};
+
+// spans recorded by one thread; kept by the tracer after the thread has exited (e.g., a worker of parallel evaluation)
+struct trace_buffer
+{
+  std::mutex                 mutex;     // only contended while the trace is written
+  std::vector<trace_event>   events;
+  size_t                     thread_id;
+  std::string                thread_name;
+};
+
+
+// Collects the spans of all threads while tracing is enabled; each thread records into its own buffer, such that threads do not
+// contend with each other. While tracing is disabled, a span costs a single atomic load.
+class tracer
+{
+  public:
+    static tracer& instance()
+    {
+      static tracer global;
+      return global;
+    }
+
+    bool enabled() const
+    {
+      return _enabled.load( std::memory_order_relaxed );
+    }
+
+    void start()
+    {
+      _enabled.store( true, std::memory_order_relaxed );
+    }
+
+    void stop()
+    {
+      _enabled.store( false, std::memory_order_relaxed );
+    }
+
+    // drops the recorded spans, and the buffers of exited threads
+    void clear()
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      _buffers.erase( std::remove_if( _buffers.begin(), _buffers.end(), []( const std::shared_ptr<trace_buffer>& buffer ) { return buffer.use_count() == 1; } ), _buffers.end() );
+      for( auto& buffer : _buffers )
+      {
+        std::lock_guard<std::mutex> buffer_lock( buffer->mutex );
+        buffer->events.clear();
+      }
+    }
+
+    static std::int64_t now_ns()
+    {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+    void record( const char* name, const char* category, std::int64_t begin_ns, std::int64_t end_ns )
+    {
+      auto& buffer = local_buffer();
+      std::lock_guard<std::mutex> lock( buffer.mutex );
+      buffer.events.push_back( trace_event{ name, category, begin_ns, end_ns } );
+    }
+
+    // names the calling thread in the trace (e.g., "compile stage")
+    void name_thread( const std::string& name )
+    {
+      local_thread_name() = name;
+      if( auto buffer = local_buffer_ptr() )
+      {
+        std::lock_guard<std::mutex> lock( buffer->mutex );
+        buffer->thread_name = name;
+      }
+    }
+
+
+    // Chrome trace event format (JSON), as read by chrome://tracing and Perfetto: a complete event ("X") per span, with
+    // timestamps in microseconds (with nanosecond decimals) since the first span, and a name per thread
+    void write_chrome_trace( std::ostream& out )
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+
+      std::int64_t origin = std::numeric_limits<std::int64_t>::max();
+      for( auto& buffer : _buffers )
+      {
+        std::lock_guard<std::mutex> buffer_lock( buffer->mutex );
+        for( const auto& event : buffer->events )
+          origin = std::min( origin, event.begin_ns );
+      }
+
+      out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+      bool first = true;
+      for( auto& buffer : _buffers )
+      {
+        std::lock_guard<std::mutex> buffer_lock( buffer->mutex );
+        if( buffer->events.empty() )
+          continue;
+
+        out << ( first ? "" : "," ) << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread_id << ",\"args\":{\"name\":";
+        write_json_string( out, buffer->thread_name.empty() ? "thread " + std::to_string( buffer->thread_id ) : buffer->thread_name );
+        out << "}}";
+        first = false;
+
+        for( const auto& event : buffer->events )
+        {
+          out << ",\n{\"name\":";
+          write_json_string( out, event.name );
+          out << ",\"cat\":";
+          write_json_string( out, event.category );
+          out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_id << ",\"ts\":";
+          write_microseconds( out, event.begin_ns - origin );
+          out << ",\"dur\":";
+          write_microseconds( out, event.end_ns - event.begin_ns );
+          out << "}";
+        }
+      }
+      out << "\n]}\n";
+    }
+
+  private:
+    std::atomic<bool>                             _enabled{ false };
+    std::mutex                                    _mutex; // guards "_buffers"
+    std::vector< std::shared_ptr<trace_buffer> >  _buffers;
+    size_t                                        _num_threads = 0; // that have recorded spans
+
+    static std::shared_ptr<trace_buffer>& local_buffer_ptr()
+    {
+      static thread_local std::shared_ptr<trace_buffer> buffer;
+      return buffer;
+    }
+
+    static std::string& local_thread_name()
+    {
+      static thread_local std::string name;
+      return name;
+    }
+
+    trace_buffer& local_buffer()
+    {
+      auto& buffer = local_buffer_ptr();
+      if( !buffer )
+      {
+        buffer = std::make_shared<trace_buffer>();
+        buffer->thread_name = local_thread_name();
+        std::lock_guard<std::mutex> lock( _mutex );
+        buffer->thread_id = ++_num_threads;
+        _buffers.push_back( buffer );
+      }
+      return *buffer;
+    }
+
+    static void write_microseconds( std::ostream& out, std::int64_t ns )
+    {
+      char digits[ 32 ];
+      std::snprintf( digits, sizeof( digits ), "%lld.%03lld", static_cast<long long>( ns / 1000 ), static_cast<long long>( ns % 1000 ) );
+      out << digits;
+    }
+
+    static void write_json_string( std::ostream& out, const std::string& str )
+    {
+      out << '"';
+      for( char c : str )
+      {
+        if( c == '"' || c == '\\' )
+          out << '\\' << c;
+        else if( static_cast<unsigned char>( c ) < 0x20 )
+        {
+          char escaped[ 8 ];
+          std::snprintf( escaped, sizeof( escaped ), "\\u%04x", static_cast<unsigned>( c ) );
+          out << escaped;
+        }
+        else
+          out << c;
+      }
+      out << '"';
+    }
+};
+
+} // namespace "detail"
+
+
+// Records the time between its construction and destruction as a span of the calling thread, if tracing is enabled (see
+// "start_tracing"); "name" and "category" must be string literals (or otherwise outlive the trace).
+class trace_span
+{
+  public:
+    explicit trace_span( const char* name, const char* category = "user" )
+      : _name( name ), _category( category ), _begin_ns( detail::tracer::instance().enabled() ? detail::tracer::now_ns() : -1 )
+    {}
+
+    trace_span( const trace_span& ) = delete;
+    trace_span& operator=( const trace_span& ) = delete;
+
+    ~trace_span()
+    {
+      if( _begin_ns >= 0 )
+        detail::tracer::instance().record( _name, _category, _begin_ns, detail::tracer::now_ns() );
+    }
+
+  private:
+    const char*   _name;
+    const char*   _category;
+    std::int64_t  _begin_ns;
+};
+
+
+inline void start_tracing()
+{
+  detail::tracer::instance().start();
+}
+
+inline void stop_tracing()
+{
+  detail::tracer::instance().stop();
+}
+
+// drops the spans recorded so far
+inline void clear_trace()
+{
+  detail::tracer::instance().clear();
+}
+
+// writes the spans recorded so far as Chrome trace JSON (to be opened in chrome://tracing or https://ui.perfetto.dev)
+inline void write_chrome_trace( const std::string& path )
+{
+  std::ofstream out( path, std::ofstream::out | std::ofstream::trunc );
+  detail::tracer::instance().write_chrome_trace( out );
+  out.close();
+  if( !out )
+    throw std::runtime_error( "cannot write trace: " + path );
+}
+
+} // namespace "atf"
+
+#endif /* trace_h */
@@ -0,0 +1,260 @@
+#ifndef tuning_log_h
+#define tuning_log_h
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "detail/columnar_log.hpp"
+
+namespace atf
+{
+
+// Tuning log written in the binary format (see "tuner::log_file"), read into memory column by column. Values are accessed per
+// column and row, either numerically or as they are written to CSV logs; a chunk torn by a crash is left out.
+class tuning_log
+{
+  public:
+    using column_type = detail::column_type;
+
+    explicit tuning_log( const std::string& path )
+      : _columns(), _num_rows( 0 )
+    {
+      std::ifstream in( path, std::ios::binary | std::ios::ate );
+      const auto file_size = static_cast<std::uint64_t>( in.tellg() );
+      in.seekg( 0 );
+      if( !in || detail::read_string( in ) != detail::columnar_log_magic() )
+        throw std::runtime_error( "not a binary tuning log: " + path );
+
+      std::uint64_t num_columns;
+      if( !detail::read_uint64( in, num_columns ) || num_columns > ( 1u << 20 ) )
+        throw std::runtime_error( "tuning log is corrupt: " + path );
+      for( std::uint64_t i = 0 ; i < num_columns ; ++i )
+      {
+        column col;
+        col.name = detail::read_string( in );
+        std::uint64_t type;
+        if( !detail::read_uint64( in, type ) || type > static_cast<std::uint64_t>( column_type::timestamp ) )
+          throw std::runtime_error( "tuning log is corrupt: " + path );
+        col.type  = static_cast<column_type>( type );
+        col.width = detail::column_width( col.type );
+        _columns.emplace_back( std::move( col ) );
+      }
+
+      while( read_chunk( in, file_size ) )
+      {}
+    }
+
+
+    size_t num_rows() const
+    {
+      return _num_rows;
+    }
+
+    size_t num_columns() const
+    {
+      return _columns.size();
+    }
+
+    const std::string& column_name( size_t column ) const
+    {
+      return _columns.at( column ).name;
+    }
+
+    column_type type( size_t column ) const
+    {
+      return _columns.at( column ).type;
+    }
+
+    // index of the column named "name" (e.g., "cost" or a tuning parameter's name)
+    size_t column_index( const std::string& name ) const
+    {
+      for( size_t i = 0 ; i < _columns.size() ; ++i )
+        if( _columns[ i ].name == name )
+          return i;
+      throw std::runtime_error( "tuning log has no column " + name );
+    }
+
+
+    // numeric value; timestamps in nanoseconds since the epoch of "std::chrono::system_clock", strings are not numeric
+    double as_double( size_t column, size_t row ) const
+    {
+      const auto& col  = _columns.at( column );
+      const char* data = col.values.data() + row * col.width;
+      switch( col.type )
+      {
+        case column_type::boolean:   return static_cast<double>( load<std::uint8_t>( data ) );
+        case column_type::int32:     return static_cast<double>( load<std::int32_t>( data ) );
+        case column_type::uint64:    return static_cast<double>( load<std::uint64_t>( data ) );
+        case column_type::float32:   return static_cast<double>( load<float>( data ) );
+        case column_type::float64:   return load<double>( data );
+        case column_type::timestamp: return static_cast<double>( load<std::int64_t>( data ) );
+        default:                     throw std::runtime_error( "column " + col.name + " is not numeric" );
+      }
+    }
+
+    // numeric column (see "as_double")
+    std::vector<double> numeric_column( const std::string& name ) const
+    {
+      const size_t column = column_index( name );
+      std::vector<double> values( _num_rows );
+      for( size_t row = 0 ; row < _num_rows ; ++row )
+        values[ row ] = as_double( column, row );
+      return values;
+    }
+
+    std::chrono::system_clock::time_point timestamp( size_t column, size_t row ) const
+    {
+      const auto& col = _columns.at( column );
+      if( col.type != column_type::timestamp )
+        throw std::runtime_error( "column " + col.name + " is not a timestamp" );
+      const auto ns = std::chrono::nanoseconds( load<std::int64_t>( col.values.data() + row * col.width ) );
+      return std::chrono::system_clock::time_point( std::chrono::duration_cast<std::chrono::system_clock::duration>( ns ) );
+    }
+
+    // value as written to CSV logs (with "out"'s precision): timestamps in local time, NaN (e.g., an unknown variance) as empty
+    void write_value( std::ostream& out, size_t column, size_t row ) const
+    {
+      const auto& col  = _columns.at( column );
+      const char* data = col.values.data() + row * col.width;
+      switch( col.type )
+      {
+        case column_type::boolean:   out << static_cast<bool>( load<std::uint8_t>( data ) ); break;
+        case column_type::int32:     out << load<std::int32_t>( data ); break;
+        case column_type::uint64:    out << load<std::uint64_t>( data ); break;
+        case column_type::float32:   out << load<float>( data ); break;
+        case column_type::float64:   if( !std::isnan( load<double>( data ) ) ) out << load<double>( data ); break;
+        case column_type::string:    out << col.dictionary.at( load<std::uint32_t>( data ) ); break;
+        case column_type::timestamp:
+        {
+          const auto ns     = load<std::int64_t>( data );
+          const auto second = static_cast<std::time_t>( ns / 1000000000 );
+          std::tm bt = *std::localtime( &second );
+          out << std::put_time( &bt, "%FT%H:%M:%S" ) << '.' << std::setfill( '0' ) << std::setw( 3 ) << ns / 1000000 % 1000 << std::setfill( ' ' );
+          break;
+        }
+      }
+    }
+
+    std::string as_string( size_t column, size_t row ) const
+    {
+      std::ostringstream out;
+      out.precision( std::numeric_limits<double>::max_digits10 );
+      write_value( out, column, row );
+      return out.str();
+    }
+
+  private:
+    struct column
+    {
+      std::string               name;
+      column_type               type;
+      size_t                    width;
+      std::vector<char>         values;
+      std::vector<std::string>  dictionary; // of string columns
+    };
+
+    std::vector<column> _columns;
+    size_t              _num_rows;
+
+    template< typename T >
+    static T load( const char* data )
+    {
+      T value;
+      std::memcpy( &value, data, sizeof( T ) );
+      return value;
+    }
+
+    // returns false at the end of the file or at a torn chunk, whose rows are dropped
+    bool read_chunk( std::ifstream& in, std::uint64_t file_size )
+    {
+      std::uint64_t marker, num_rows;
+      if( !detail::read_uint64( in, marker ) || marker != detail::columnar_log_chunk_marker() || !detail::read_uint64( in, num_rows ) || num_rows > ( 1ull << 32 ) )
+        return false;
+
+      // the values of the chunk's rows must fit into the rest of the file, before memory is allocated for them
+      std::uint64_t row_width = 0;
+      for( const auto& col : _columns )
+        row_width += col.width;
+      if( num_rows * row_width > file_size - static_cast<std::uint64_t>( in.tellg() ) )
+        return false;
+
+      std::vector<size_t> sizes;
+      std::vector<size_t> dictionary_sizes;
+      bool ok = true;
+      for( auto& col : _columns )
+      {
+        dictionary_sizes.push_back( col.dictionary.size() );
+        if( col.type == column_type::string )
+        {
+          std::uint64_t num_entries;
+          ok = ok && detail::read_uint64( in, num_entries );
+          for( std::uint64_t i = 0 ; ok && i < num_entries ; ++i )
+          {
+            col.dictionary.emplace_back( detail::read_string( in ) );
+            ok = in.good();
+          }
+        }
+
+        sizes.push_back( col.values.size() );
+        if( ok )
+        {
+          col.values.resize( col.values.size() + num_rows * col.width );
+          ok = num_rows == 0 || detail::read_bytes( in, col.values.data() + sizes.back(), num_rows * col.width );
+        }
+      }
+
+      ok = ok && detail::read_uint64( in, marker ) && marker == detail::columnar_log_chunk_marker();
+      if( !ok )
+      {
+        for( size_t i = 0 ; i < sizes.size() ; ++i )
+        {
+          _columns[ i ].values.resize( sizes[ i ] );
+          _columns[ i ].dictionary.resize( dictionary_sizes[ i ] );
+        }
+        return false;
+      }
+
+      _num_rows += num_rows;
+      return true;
+    }
+};
+
+
+// converts a binary tuning log to a CSV log as written by "tuner::log_file" with the CSV format
+inline void convert_to_csv( const std::string& log_path, const std::string& csv_path )
+{
+  const tuning_log log( log_path );
+
+  std::ofstream csv( csv_path, std::ofstream::out | std::ofstream::trunc );
+  if( !csv )
+    throw std::runtime_error( "cannot write CSV log: " + csv_path );
+  csv.precision( std::numeric_limits<double>::max_digits10 );
+
+  for( size_t column = 0 ; column < log.num_columns() ; ++column )
+    csv << ( column == 0 ? "" : ";" ) << log.column_name( column );
+  for( size_t row = 0 ; row < log.num_rows() ; ++row )
+  {
+    csv << '\n';
+    for( size_t column = 0 ; column < log.num_columns() ; ++column )
+    {
+      if( column > 0 )
+        csv << ';';
+      log.write_value( csv, column, row );
+    }
+  }
+}
+
+} // namespace "atf"
+
+#endif /* tuning_log_h */
@@ -3,6 +3,7 @@
 
 #include <tuple>
 #include "tp_value.hpp"
+#include "pareto_archive.hpp"
 
 namespace atf {
 
@@ -22,9 +23,20 @@ public:
     auto number_of_invalid_configs() const {
         return _number_of_invalid_configs;
     }
+    // invalid configurations whose evaluation exceeded its time limit (see "atf::isolated")
+    auto number_of_timeouts() const {
+        return _number_of_timeouts;
+    }
     auto number_of_valid_configs() const {
         return _number_of_evaluated_configs - _number_of_invalid_configs;
     }
+    // evaluated configurations whose results were taken from the result cache (included in the evaluated configurations)
+    auto number_of_cache_hits() const {
+        return _number_of_cache_hits;
+    }
+    double cache_hit_rate() const {
+        return _number_of_evaluated_configs == 0 ? 0.0 : static_cast<double>( _number_of_cache_hits ) / _number_of_evaluated_configs;
+    }
     auto evaluations_required_to_find_best_found_result() const {
         return _evaluations_required_to_find_best_found_result;
     }
@@ -34,6 +46,10 @@ public:
     auto history() const {
         return _history;
     }
+    // configurations not dominated w.r.t. the tuner's objectives (empty without objectives, see "tuner::objectives")
+    const pareto_archive& pareto_front() const {
+        return _pareto_front;
+    }
     auto tuning_start_time() const {
         return std::get<0>( _history.front() );
     }
@@ -44,10 +60,13 @@ private:
 
     size_t                                      _number_of_evaluated_configs;
     size_t                                      _number_of_invalid_configs;
+    size_t                                      _number_of_timeouts;
+    size_t                                      _number_of_cache_hits;
     size_t                                      _evaluations_required_to_find_best_found_result;
     size_t                                      _valid_evaluations_required_to_find_best_found_result;
     using                                        history_entry = std::tuple< std::chrono::steady_clock::time_point, configuration, cost_t >; // entry: actual tuning runtime, configuration, configuration's cost
     std::vector<history_entry>                  _history; // history of best results
+    pareto_archive                              _pareto_front;
 };
 
 }
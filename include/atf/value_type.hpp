@@ -3,6 +3,10 @@
 #define value_type_h
 
 #include <string>
+#include <type_traits>
+#include <assert.h>
+
+#include "detail/string_table.hpp"
 
 namespace atf
 {
@@ -38,7 +42,7 @@ class value_type
       : _type_id( double_t ), _double_val( d )
     {}
     value_type( const std::string& s   )
-      : _type_id( string_t ), _string_val( s )
+      : _type_id( string_t ), _string_val( detail::string_table::intern( s ) )
     {}
   
 
@@ -271,7 +275,7 @@ class value_type
           break;
 
         case string_t:
-          return _string_val;
+          return *_string_val;
           break;
 
         default:
@@ -314,139 +318,40 @@ class value_type
   
 
   
-    // c-ctor, c-assignment and ddtor have to be explicitly stated due to std::string in union member
-    value_type( const value_type& other )
+    // the stored value without conversion; "T" has to be the type of the stored value
+    template< typename T >
+    const T& native() const
     {
-      switch( other.type_id() )
-      {
-        case root_t:
-          _type_id = root_t;
-          break;
-
-        case bool_t:
-          _type_id  = bool_t;
-          _bool_val = other._bool_val;
-          break;
-
-        case int_t:
-          _type_id = int_t;
-          _int_val = other._int_val;
-          break;
-
-        case size_t_t:
-          _type_id    = size_t_t;
-          _size_t_val = other._size_t_val;
-          break;
-
-        case float_t:
-          _type_id    = float_t;
-          _float_val = other._float_val;
-          break;
-
-        case double_t:
-          _type_id    = double_t;
-          _double_val = other._double_val;
-          break;
-
-        case string_t:
-          _type_id = string_t;
-          new (&_string_val) auto( other._string_val );
-          break;
-
-        default:
-          throw std::exception();
-      }
-
+      return native( native_tag<T>() );
     }
-  
-    value_type& operator=( const value_type& other )
-    {
-      // check for self-assignment
-      if( &other == this )
-          return *this;
 
-      switch( other.type_id() )
-      {
-        case root_t:
-          assert( false );       return *this;
-          break;
 
-        case bool_t:
-          this->_type_id = bool_t;
-          this->_bool_val = other._bool_val;
-          return *this;
-          break;
-
-        case int_t:
-          this->_type_id = int_t;
-          this->_int_val = other._int_val;
-          return *this;
-          break;
-
-        case size_t_t:
-          this->_type_id    = size_t_t;
-          this->_size_t_val = other._size_t_val;
-          return *this;
-          break;
-
-        case float_t:
-          this->_type_id   = float_t;
-          this->_float_val = other._float_val;
-          return *this;
-          break;
-
-        case double_t:
-          this->_type_id    = double_t;
-          this->_double_val = other._double_val;
-          return *this;
-          break;
-
-        case string_t:
-          this->_type_id    = string_t;
-          this->_string_val = other._string_val;
-          return *this;
-          break;
-
-        default:
-          throw std::exception();
-      }
-
-    }
-  
-    ~value_type()
-    {
-      switch( this->type_id() )
-      {
-        case root_t:
-        case bool_t:
-        case int_t:
-        case size_t_t:
-        case float_t:
-        case double_t:
-          break; // trivially destructible, no need to do anything
+  private:
+    template< typename T >
+    struct native_tag {};
 
-        case string_t:
-          _string_val.~basic_string();       break;
+    const bool&        native( native_tag<bool>        ) const { assert( _type_id == bool_t   ); return _bool_val;   }
+    const int&         native( native_tag<int>         ) const { assert( _type_id == int_t    ); return _int_val;    }
+    const size_t&      native( native_tag<size_t>      ) const { assert( _type_id == size_t_t ); return _size_t_val; }
+    const float&       native( native_tag<float>       ) const { assert( _type_id == float_t  ); return _float_val;  }
+    const double&      native( native_tag<double>      ) const { assert( _type_id == double_t ); return _double_val; }
+    const std::string& native( native_tag<std::string> ) const { assert( _type_id == string_t ); return *_string_val; }
 
-        default:
-//          throw std::runtime_error("unknown type");
-          std::terminate();
-      }
-    }
-  
-  private:
     type_id_t _type_id;
   
     union     {
-      bool        _bool_val;
-      int         _int_val;
-      size_t      _size_t_val;
-      float       _float_val;
-      double      _double_val;
-      std::string _string_val;
+      bool               _bool_val;
+      int                _int_val;
+      size_t             _size_t_val;
+      float              _float_val;
+      double             _double_val;
+      const std::string* _string_val; // interned
     };
 };
 
+static_assert( sizeof( value_type ) == 16,                         "value_type is expected to be 16 bytes"    );
+static_assert( std::is_trivially_copyable<value_type>::value,    "value_type is expected to be memcpy-able" );
+
 // overloaded operators
 std::ostream& operator<< (std::ostream &out, const value_type& value )
 {
@@ -512,7 +417,7 @@ bool operator!=( const value_type& lhs, const value_type& rhs )
       break;
 
     case value_type::string_t:
-      return ( lhs.string_val() != rhs.string_val() );
+      return ( &lhs.native<std::string>() != &rhs.native<std::string>() ); // strings are interned
       break;
 
     default:
@@ -549,7 +454,7 @@ bool operator<( const value_type& lhs, const value_type& rhs )
       break;
 
     case value_type::string_t:
-      return ( lhs.string_val() < rhs.string_val() );
+      return ( lhs.native<std::string>() < rhs.native<std::string>() );
       break;
 
     default:
@@ -0,0 +1,32 @@
+#include <vector>
+
+#include <atf.hpp>
+#include "check.hpp"
+
+template< typename T, typename range_t, typename callable >
+std::vector<T> values_of( atf::tp_t<T,range_t,callable>& tp )
+{
+  std::vector<T> values;
+  T value;
+  while( tp.get_next_value( value ) )
+    values.push_back( value );
+  return values;
+}
+
+int main()
+{
+  // bounds on an interval whose width exceeds the range of "int": the enumerated values must lie on the interval's grid
+  auto A = atf::tuning_parameter( "A", atf::interval<int>( -2000000000, 2000000000, 3 ),
+                                  atf::greater_than( 1000000000 ) && atf::less_than( 1000000012 ) );
+  CHECK(( values_of( A ) == std::vector<int>{ 1000000003, 1000000006, 1000000009 } ));
+
+  // the last value of a wide interval is reached without overflowing the stride
+  auto B = atf::tuning_parameter( "B", atf::interval<int>( -2000000000, 2000000000, 1000000000 ),
+                                  atf::greater_than_or_eq( -2000000000 ) );
+  CHECK(( values_of( B ) == std::vector<int>{ -2000000000, -1000000000, 0, 1000000000, 2000000000 } ));
+
+  // the values equal the ones of the unnarrowed enumeration
+  auto C = atf::tuning_parameter( "C", atf::interval<int>( -100, 100, 7 ), atf::less_than( 50 ) );
+  auto D = atf::tuning_parameter( "D", atf::interval<int>( -100, 100, 7 ), []( int d ){ return d < 50; } );
+  CHECK( values_of( C ) == values_of( D ) );
+}
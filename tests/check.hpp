@@ -0,0 +1,18 @@
+#ifndef atf_tests_check_h
+#define atf_tests_check_h
+
+#include <iostream>
+#include <cstdlib>
+
+// reports a failed check with its location and exits with a non-zero code
+#define CHECK( condition )                                                                               \
+  do                                                                                                     \
+  {                                                                                                      \
+    if( !( condition ) )                                                                                 \
+    {                                                                                                    \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl;          \
+      std::exit( EXIT_FAILURE );                                                                         \
+    }                                                                                                    \
+  } while( false )
+
+#endif /* atf_tests_check_h */
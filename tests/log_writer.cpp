@@ -0,0 +1,34 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <atf.hpp>
+#include "check.hpp"
+
+int main()
+{
+  // the log writers written on termination by a signal are registered in a table of fixed size: opening one more fails loudly
+  std::vector< std::unique_ptr<atf::detail::log_writer> > writers;
+  bool full = false;
+  for( size_t i = 0 ; i <= 16 && !full ; ++i )
+  {
+    writers.emplace_back( new atf::detail::log_writer() );
+    try
+    {
+      writers.back()->open( "log_writer_test_" + std::to_string( i ) + ".csv" );
+    }
+    catch( const std::runtime_error& )
+    {
+      full = true;
+    }
+  }
+  CHECK( full );
+  CHECK( writers.size() == 17 );
+  CHECK( !writers.back()->is_open() );
+
+  // a closed log writer frees its entry
+  writers.front()->close();
+  writers.back()->open( "log_writer_test_16.csv" );
+  CHECK( writers.back()->is_open() && *writers.back() );
+}
@@ -0,0 +1,37 @@
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include <atf.hpp>
+#include "check.hpp"
+
+using config_t = std::tuple<int,int,int>;
+
+// configurations in the order in which exhaustive search evaluates them
+std::vector<config_t> explored( bool split )
+{
+  auto A = atf::tuning_parameter( "A", atf::interval<int>( 1, 2 ) );
+  auto B = atf::tuning_parameter( "B", atf::interval<int>( 1, 2 ) );
+  auto C = atf::tuning_parameter( "C", atf::interval<int>( 1, 2 ), atf::less_than_or_eq( A ) );
+
+  std::vector<config_t> configs;
+  auto cf = [&]( atf::configuration& config ){
+    configs.emplace_back( config[ "A" ].value().int_val(), config[ "B" ].value().int_val(), config[ "C" ].value().int_val() );
+    return static_cast<atf::cost_t>( configs.size() );
+  };
+  atf::tuner().silent( true ).split_independent_tps( split ).tuning_parameters( A, B, C ).search_technique( atf::exhaustive() ).tune( cf );
+  return configs;
+}
+
+int main()
+{
+  // without splitting, the TPs form one group in their order: the values of "C" vary fastest
+  std::vector<config_t> unsplit = explored( false );
+  CHECK(( unsplit == std::vector<config_t>{ config_t( 1, 1, 1 ), config_t( 1, 2, 1 ), config_t( 2, 1, 1 ), config_t( 2, 1, 2 ), config_t( 2, 2, 1 ), config_t( 2, 2, 2 ) } ));
+
+  // split into the groups "A, C" and "B", the TPs are reordered, and span the same configurations
+  std::vector<config_t> split = explored( true );
+  CHECK( split != unsplit );
+  std::sort( split.begin(), split.end() );
+  CHECK( split == unsplit );
+}
@@ -0,0 +1,28 @@
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <atf.hpp>
+#include "check.hpp"
+
+int main()
+{
+  const std::string path = "tuning_log_test.atflog";
+
+  auto A  = atf::tuning_parameter( "A", atf::interval<int>( 1, 100 ) );
+  auto cf = []( atf::configuration& config ){ return static_cast<atf::cost_t>( config[ "A" ].value().int_val() ); };
+  atf::tuner().silent( true ).log_file( path, atf::log_format::binary ).tuning_parameters( A ).tune( cf, atf::evaluations( 10 ) );
+  CHECK( atf::tuning_log( path ).num_rows() == 10 );
+
+  // a chunk whose number of rows exceeds the rest of the file is torn: it is dropped without allocating memory for its rows
+  std::string bytes( ( std::istreambuf_iterator<char>( std::ifstream( path, std::ios::binary ).rdbuf() ) ), std::istreambuf_iterator<char>() );
+  const std::uint64_t marker   = atf::detail::columnar_log_chunk_marker();
+  const auto          chunk    = bytes.find( std::string( reinterpret_cast<const char*>( &marker ), sizeof( marker ) ) );
+  const std::uint64_t num_rows = std::uint64_t( 1 ) << 32;
+  CHECK( chunk != std::string::npos );
+  std::memcpy( &bytes[ chunk + sizeof( marker ) ], &num_rows, sizeof( num_rows ) );
+  std::ofstream( path, std::ios::binary | std::ios::trunc ).write( bytes.data(), bytes.size() );
+  CHECK( atf::tuning_log( path ).num_rows() == 0 );
+}